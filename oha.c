@@ -1,3 +1,9 @@
 #include "oha.h"
 
 #include "oha_lpht_impl.h"
+#include "oha_bh_impl.h"
+#include "oha_rxh_impl.h"
+#include "oha_tpht_impl.h"
+#include "oha_mq_impl.h"
+#include "oha_cache_impl.h"
+#include "oha_htw_impl.h"
@@ -19,6 +19,13 @@ extern "C" {
 #define OHA_PUBLIC_API
 #endif
 
+#ifdef OHA_WITH_TRACE_SUPPORT
+// traced functions have side effects
+#define OHA_PURE
+#else
+#define OHA_PURE __attribute__((pure))
+#endif
+
 #ifdef OHA_DISABLE_NULL_POINTER_CHECKS
 #define OHA_NULL_POINTER_CHECKS 0
 #else
@@ -60,8 +67,69 @@ struct oha_lpht_config {
     size_t value_size;
     struct oha_memory_fp memory;
     bool resizable;
+    /*
+     * Bits per element of an optional bloom filter, which is checked before the key buckets are probed. It saves
+     * the cache misses of most look ups of keys not in the table. The filter is disabled with 0 and rounded up to
+     * a power of two, 8 bits give a false positive rate of about 3%, 16 bits less than 0.1%.
+     */
+    uint8_t filter_bits_per_elem;
+    /*
+     * The iteration follows the insertion order instead of the bucket order. Each element needs an additional
+     * entry of the key size and a pointer in a dense array, which is scanned by the iterator.
+     */
+    bool insertion_ordered;
+    /*
+     * Keeps one bit per bucket to skip 64 empty buckets at once by iterations, clear, resizes and filter rebuilds.
+     * Every insert and remove updates the bitmap, which costs an additional memory access.
+     */
+    bool occupied_bitmap;
+    /*
+     * Closes the gap of a removed element by moving the rest of its cluster with a single memmove instead of bucket
+     * by bucket. It pays off for long clusters, i.e. high load factors and churn with many removes.
+     */
+    bool block_backward_shift;
+    /*
+     * Resizable tables multiply their maximum number of elements by this factor to grow, 0 means 2. Other factors
+     * than 2, e.g. 1.5 or 1.25 for memory constrained hosts, size the bucket array exactly instead of to a power of
+     * two and map the hash to a start bucket by a multiplication instead of a mask. Every growth allocates a value
+     * buffer, so the factor has to reach 2^32 elements from max_elems within 65535 steps, e.g. 1.001 from 1. Reserves
+     * and batches therefore grow by at least this factor, too.
+     */
+    float growth_factor;
+    /*
+     * Resizable tables also grow, if an insert probes further than this number of buckets and the table is at least
+     * half full. Together with a high load factor as upper bound, the table grows by the cluster length instead of
+     * the element count. Disabled with 0.
+     */
+    uint16_t grow_probe_length;
+    /*
+     * Bounds the probe sequence length, so a look up compares at most max_probe_length + 1 buckets. A key, which does
+     * not fit into its window, lets a resizable table grow if it is at least half full, otherwise the insert fails.
+     * So colliding keys are rejected instead of growing the table without a limit. Disabled with 0, the compile time
+     * option OHA_MAX_LOG_N_PROBING limits the bound additionally to log2 of the number of buckets. With the compile
+     * time option OHA_WITH_HASH_TAGS the hash tag takes a byte of the probe sequence length, which limits it to 127.
+     */
+    uint16_t max_probe_length;
+    /*
+     * Resizable tables shrink, if a remove lets the load factor fall below this value, but never below the initial
+     * size. A shrink fills the table to max_load_factor / growth_factor, which has to be greater for a hysteresis.
+     * Values are never moved, so a shrink releases the key buckets and only the value buffers without an element.
+     * A drained table returns to its initial size. The value of a removed element stays readable until the next call
+     * which modifies the table, a shrink invalidates running iterations. Disabled with 0.
+     */
+    float shrink_load_factor;
 };
 
+/*
+ * Returns true if the element should be erased. The value memory is released after the call.
+ */
+typedef bool (*oha_lpht_erase_predicate_fp)(const void * key, void * value, void * ctx);
+
+/*
+ * Initializes a new or merges into an existing value of an upsert call, 'value' is updated in place.
+ */
+typedef void (*oha_lpht_upsert_fp)(const void * key, void * value, void * ctx);
+
 struct oha_lpht_status {
     uint32_t max_elems;
     uint32_t elems_in_use;
@@ -73,14 +141,81 @@ OHA_PUBLIC_API struct oha_lpht *
 oha_lpht_create(const struct oha_lpht_config * config);
 OHA_PUBLIC_API void
 oha_lpht_destroy(struct oha_lpht * table);
-__attribute__((pure)) OHA_PUBLIC_API void *
+OHA_PURE OHA_PUBLIC_API void *
 oha_lpht_look_up(const struct oha_lpht * table, const void * key);
+/*
+ * Checks whether the key is in the table without touching its value, a miss costs usually a single bucket.
+ */
+OHA_PURE OHA_PUBLIC_API bool
+oha_lpht_contains(const struct oha_lpht * table, const void * key);
+/*
+ * Looks up 'num_keys' keys, stored one after another in 'keys', and returns the value of the i-th key in 'values[i]'
+ * (NULL if the key is not in the table). The look ups are interleaved to overlap their cache misses, which pays off
+ * for tables much larger than the cache. Returns the number of found keys.
+ */
+OHA_PUBLIC_API uint32_t
+oha_lpht_look_up_batch(const struct oha_lpht * table, const void * keys, size_t num_keys, void ** values);
 OHA_PUBLIC_API void *
 oha_lpht_insert(struct oha_lpht * table, const void * key);
+/*
+ * Inserts the key with a single probe and calls 'init' if the key is new or 'merge' if it was already in the table,
+ * both may be NULL. The table must not be modified by the callbacks. Returns the value or NULL on error.
+ */
+OHA_PUBLIC_API void *
+oha_lpht_upsert(struct oha_lpht * table,
+                const void * key,
+                oha_lpht_upsert_fp init,
+                oha_lpht_upsert_fp merge,
+                void * ctx);
 OHA_PUBLIC_API void *
 oha_lpht_remove(struct oha_lpht * table, const void * key);
+/*
+ * Returns the hash of the key as used by the table. All tables with the same key size hash a key equally, so the hash
+ * can be computed once and passed to the *_hashed functions of several tables. Passing a different hash for a key is
+ * undefined behavior.
+ */
+OHA_PURE OHA_PUBLIC_API uint32_t
+oha_lpht_hash_key(const struct oha_lpht * table, const void * key);
+OHA_PURE OHA_PUBLIC_API void *
+oha_lpht_look_up_hashed(const struct oha_lpht * table, const void * key, uint32_t hash);
+OHA_PUBLIC_API void *
+oha_lpht_insert_hashed(struct oha_lpht * table, const void * key, uint32_t hash);
+OHA_PUBLIC_API void *
+oha_lpht_remove_hashed(struct oha_lpht * table, const void * key, uint32_t hash);
+/*
+ * Removes 'num_keys' keys, stored one after another in 'keys'. If 'values' is not NULL, the value of the i-th key
+ * is returned in 'values[i]' (NULL if the key was not found). Returns the number of removed keys.
+ */
+OHA_PUBLIC_API uint32_t
+oha_lpht_remove_batch(struct oha_lpht * table, const void * keys, size_t num_keys, void ** values);
+/*
+ * Removes all elements matching the predicate in a single pass over the table. Returns the number of removed elements.
+ * The table must not be modified by the predicate.
+ */
+OHA_PUBLIC_API uint32_t
+oha_lpht_erase_if(struct oha_lpht * table, oha_lpht_erase_predicate_fp predicate, void * ctx);
+/*
+ * Removes all elements, but keeps the allocated memory for the next inserts.
+ */
+OHA_PUBLIC_API void
+oha_lpht_clear(struct oha_lpht * table);
 OHA_PUBLIC_API int
 oha_lpht_get_status(const struct oha_lpht * table, struct oha_lpht_status * status);
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+/*
+ * Returns the key of a value returned by the insert or look up functions in O(1). The key is stored as copy next to
+ * the value and stays valid as long as the element is in the table.
+ */
+OHA_PUBLIC_API const void *
+oha_lpht_get_key_from_value(const struct oha_lpht * table, const void * value);
+#endif
+/*
+ * Inserts 'num_keys' keys, stored one after another in 'keys', with a single growth check for the whole batch.
+ * The value of the i-th key is returned in 'values[i]' (NULL if it could not be inserted) and, if 'inserted' is not
+ * NULL, 'inserted[i]' tells whether the key was new or already in the table. Returns 0 if all keys are placed.
+ */
+OHA_PUBLIC_API int
+oha_lpht_insert_batch(struct oha_lpht * table, const void * keys, size_t num_keys, void ** values, bool * inserted);
 OHA_PUBLIC_API int
 oha_lpht_reserve(struct oha_lpht * table, uint32_t elements);
 OHA_PUBLIC_API int
@@ -88,9 +223,388 @@ oha_lpht_iter_init(struct oha_lpht * table);
 OHA_PUBLIC_API int
 oha_lpht_iter_next(struct oha_lpht * table, struct oha_key_value_pair * pair);
 
+#ifdef OHA_WITH_TRACE_SUPPORT
+/*
+ * Records every insert, look up and remove call as binary record into a buffer of 'buffer_records' entries,
+ * which is written to 'file_path' each time it is full. A record is the operation ('+', '?' or '-'), followed by
+ * the key (key_size bytes) and a 64 bit nanosecond time stamp in host byte order, see test/benchmark.cpp.
+ */
+OHA_PUBLIC_API int
+oha_lpht_trace_start(struct oha_lpht * table, const char * file_path, uint32_t buffer_records);
+OHA_PUBLIC_API int
+oha_lpht_trace_flush(struct oha_lpht * table);
+OHA_PUBLIC_API int
+oha_lpht_trace_stop(struct oha_lpht * table);
+#endif
+
+/**********************************************************************************************************************
+ *  binary heap (bh)
+ *
+ *      - min heap of 64 bit keys, every key has a connected value of 'value_size' bytes
+ *      - values are never moved, the pointer of a value identifies its element until it is removed
+ *
+ **********************************************************************************************************************/
+struct oha_bh;
+
+struct oha_bh_config {
+    struct oha_memory_fp memory;
+    size_t value_size;
+    uint32_t max_elems;
+    bool resizable;
+    /*
+     * Number of children per node: 2 (also 0), 4 or 8. The keys are stored separated from the values and all
+     * children of a node share one cache line, so a wider heap needs less levels and cache misses per sift down,
+     * but compares more keys per level.
+     */
+    uint8_t arity;
+};
+
+struct oha_bh_status {
+    uint32_t max_elems;
+    uint32_t elems_in_use;
+    size_t size_in_bytes;
+};
+
+OHA_PUBLIC_API struct oha_bh *
+oha_bh_create(const struct oha_bh_config * config);
+OHA_PUBLIC_API void
+oha_bh_destroy(struct oha_bh * heap);
+/*
+ * Returns the value of the smallest key and stores the key in 'key' if it is not NULL. Returns NULL if the heap
+ * is empty.
+ */
+OHA_PUBLIC_API void *
+oha_bh_find_min(const struct oha_bh * heap, int64_t * key);
+/*
+ * Removes the element with the smallest key. The returned value memory stays valid until the next insert.
+ */
+OHA_PUBLIC_API void *
+oha_bh_delete_min(struct oha_bh * heap);
+OHA_PUBLIC_API void *
+oha_bh_insert(struct oha_bh * heap, int64_t key);
+/*
+ * Inserts all keys and stores their values in 'values'. Either all or no keys are inserted. When at least as many
+ * keys are inserted as the heap holds, the heap is rebuilt bottom up in O(n) instead of n inserts in O(log n).
+ */
+OHA_PUBLIC_API int
+oha_bh_insert_batch(struct oha_bh * heap, const int64_t * keys, size_t num_keys, void ** values);
+/*
+ * Removes up to 'num' elements with the smallest keys in ascending order and returns the number of removed
+ * elements. The keys are stored in 'keys' if it is not NULL. The value memory stays valid until the next insert.
+ * The elements are removed one after another, the call only saves the per call overhead.
+ */
+OHA_PUBLIC_API size_t
+oha_bh_delete_min_batch(struct oha_bh * heap, size_t num, int64_t * keys, void ** values);
+OHA_PURE OHA_PUBLIC_API int64_t
+oha_bh_get_key(const struct oha_bh * heap, const void * value);
+OHA_PUBLIC_API int
+oha_bh_change_key(struct oha_bh * heap, void * value, int64_t new_key);
+/*
+ * Removes the element of the value. The value memory stays valid until the next insert.
+ */
+OHA_PUBLIC_API int
+oha_bh_remove(struct oha_bh * heap, void * value);
+OHA_PUBLIC_API int
+oha_bh_get_status(const struct oha_bh * heap, struct oha_bh_status * status);
+
+/**********************************************************************************************************************
+ *  radix heap (rxh)
+ *
+ *      - monotone min heap of 64 bit keys with the same interface as the binary heap
+ *      - insert, change key and remove in O(1), delete min in amortized O(log16 C) with the key range C
+ *      - keys less than the last removed minimum are ordered as this minimum, e.g. timestamps in the past
+ *
+ **********************************************************************************************************************/
+struct oha_rxh;
+
+struct oha_rxh_config {
+    struct oha_memory_fp memory;
+    size_t value_size;
+    uint32_t max_elems;
+    bool resizable;
+};
+
+OHA_PUBLIC_API struct oha_rxh *
+oha_rxh_create(const struct oha_rxh_config * config);
+OHA_PUBLIC_API void
+oha_rxh_destroy(struct oha_rxh * heap);
+/*
+ * Returns the value of the smallest key and stores the key in 'key' if it is not NULL. Returns NULL if the heap
+ * is empty. The heap is not const, because the smallest keys are sorted out on demand.
+ */
+OHA_PUBLIC_API void *
+oha_rxh_find_min(struct oha_rxh * heap, int64_t * key);
+/*
+ * Removes the element with the smallest key. The returned value memory stays valid until the next insert.
+ */
+OHA_PUBLIC_API void *
+oha_rxh_delete_min(struct oha_rxh * heap);
+OHA_PUBLIC_API void *
+oha_rxh_insert(struct oha_rxh * heap, int64_t key);
+OHA_PURE OHA_PUBLIC_API int64_t
+oha_rxh_get_key(const struct oha_rxh * heap, const void * value);
+OHA_PUBLIC_API int
+oha_rxh_change_key(struct oha_rxh * heap, void * value, int64_t new_key);
+/*
+ * Removes the element of the value. The value memory stays valid until the next insert.
+ */
+OHA_PUBLIC_API int
+oha_rxh_remove(struct oha_rxh * heap, void * value);
+OHA_PUBLIC_API int
+oha_rxh_get_status(const struct oha_rxh * heap, struct oha_bh_status * status);
+
+/**********************************************************************************************************************
+ *  temporal prioritized hash table (tpht)
+ *
+ *      - lpht where every element has a deadline, the deadlines are ordered by a binary heap or a radix heap
+ *      - due elements are removed in O(log n) each, without scanning the table
+ *      - the time unit of the deadlines is defined by the user, e.g. seconds or nanoseconds
+ *
+ **********************************************************************************************************************/
+struct oha_tpht;
+
+struct oha_tpht_config {
+    /*
+     * The value size is the size of the user values, the table adds the reference to its deadline. The deadline
+     * heap follows max_elems and resizable of the table.
+     */
+    struct oha_lpht_config table_config;
+    uint8_t heap_arity; // arity of the deadline heap, see struct oha_bh_config
+    /*
+     * Orders the deadlines by a radix heap instead of the binary heap, if the deadlines are timestamps which only
+     * grow. Inserts and deadline changes are O(1) then, deadlines before the last expired deadline are ordered as
+     * this deadline.
+     */
+    bool monotone_deadlines;
+};
+
+/*
+ * Is called for every expired element. The value memory is released after the call and the table must not be
+ * modified by the callback.
+ */
+typedef void (*oha_tpht_expired_fp)(const void * key, void * value, void * ctx);
+/*
+ * Returns the new deadline of the element, the table must not be modified by the callback.
+ */
+typedef int64_t (*oha_tpht_deadline_fp)(const void * key, void * value, void * ctx);
+
+OHA_PUBLIC_API struct oha_tpht *
+oha_tpht_create(const struct oha_tpht_config * config);
+OHA_PUBLIC_API void
+oha_tpht_destroy(struct oha_tpht * table);
+/*
+ * Returns NULL also for elements whose deadline is less than or equal to 'now'. The elements are kept until
+ * they are passed to the callback of oha_tpht_expire().
+ */
+OHA_PURE OHA_PUBLIC_API void *
+oha_tpht_look_up(const struct oha_tpht * table, const void * key, int64_t now);
+/*
+ * Inserts the key with the deadline or returns the value of the element already in the table, whose deadline is
+ * not changed. An element with a deadline less than or equal to 'now' is replaced instead: it gets the new
+ * deadline and its value is not passed to the callback of oha_tpht_expire(). 'inserted' is set to true for a new
+ * or replaced element, whose value has to be initialized by the caller, it could be NULL.
+ */
+OHA_PUBLIC_API void *
+oha_tpht_insert(struct oha_tpht * table, const void * key, int64_t deadline, int64_t now, bool * inserted);
+OHA_PUBLIC_API void *
+oha_tpht_remove(struct oha_tpht * table, const void * key);
+/*
+ * 'value' is a value returned by the insert or look up function.
+ */
+OHA_PUBLIC_API int
+oha_tpht_set_deadline(struct oha_tpht * table, void * value, int64_t deadline);
+/*
+ * Assigns the deadlines returned by the callback to all elements and rebuilds the deadline order at once in O(n),
+ * e.g. after a configuration reload.
+ */
+OHA_PUBLIC_API int
+oha_tpht_reset_deadlines(struct oha_tpht * table, oha_tpht_deadline_fp callback, void * ctx);
+OHA_PURE OHA_PUBLIC_API int64_t
+oha_tpht_get_deadline(const struct oha_tpht * table, const void * value);
+/*
+ * Stores the earliest deadline of all elements in 'deadline'. Returns false if the table is empty.
+ */
+OHA_PUBLIC_API bool
+oha_tpht_next_deadline(const struct oha_tpht * table, int64_t * deadline);
+/*
+ * Removes all elements with a deadline less than or equal to 'now' and passes them to the optional callback.
+ * The run time only depends on the number of expired elements. Returns the number of expired elements.
+ * The binary deadline heap removes the due elements in batches, the callback order inside of a batch does not
+ * follow the deadlines.
+ */
+OHA_PUBLIC_API uint32_t
+oha_tpht_expire(struct oha_tpht * table, int64_t now, oha_tpht_expired_fp callback, void * ctx);
+OHA_PUBLIC_API int
+oha_tpht_get_status(const struct oha_tpht * table, struct oha_lpht_status * status);
+
+/**********************************************************************************************************************
+ *  multi queue (mq)
+ *
+ *      - thread safe tpht, the keys are distributed over independently locked tpht shards
+ *      - multiple consumers expire concurrently by popping from the earlier of two random shards (MultiQueue), the
+ *        expiry order over all shards is relaxed
+ *      - values are copied in and out under the lock of the shard, so no pointer into a shard escapes
+ *
+ **********************************************************************************************************************/
+struct oha_mq;
+
+struct oha_mq_config {
+    struct oha_tpht_config shard_config; // configuration of each shard, max_elems is the capacity per shard
+    uint32_t num_shards;                 // e.g. 2-4 times the number of threads
+};
+
+/*
+ * The functions are thread safe, except create and destroy.
+ */
+OHA_PUBLIC_API struct oha_mq *
+oha_mq_create(const struct oha_mq_config * config);
+OHA_PUBLIC_API void
+oha_mq_destroy(struct oha_mq * mq);
+/*
+ * Copies the value into a new element, 'value' could be NULL. Returns 0 if the key was inserted, 1 if the key is
+ * already in the queue (the element is not changed) and -1 on failure. An element with a deadline less than or
+ * equal to 'now' is replaced like by oha_tpht_insert().
+ */
+OHA_PUBLIC_API int
+oha_mq_insert(struct oha_mq * mq, const void * key, const void * value, int64_t deadline, int64_t now);
+/*
+ * Copies the value of a not yet expired element to 'value', if 'value' is not NULL.
+ */
+OHA_PUBLIC_API bool
+oha_mq_look_up(struct oha_mq * mq, const void * key, int64_t now, void * value);
+OHA_PUBLIC_API bool
+oha_mq_remove(struct oha_mq * mq, const void * key, void * value);
+OHA_PUBLIC_API int
+oha_mq_set_deadline(struct oha_mq * mq, const void * key, int64_t deadline);
+/*
+ * Removes at most 'max_expired' elements with a deadline less than or equal to 'now' and returns their number.
+ * Could be called by multiple threads at once. The callback is called with the lock of the shard of the element,
+ * so it must not call a function of the same queue. Returns less than 'max_expired' only if no shard had a due
+ * element.
+ */
+OHA_PUBLIC_API uint32_t
+oha_mq_expire(struct oha_mq * mq, int64_t now, uint32_t max_expired, oha_tpht_expired_fp callback, void * ctx);
+OHA_PUBLIC_API int
+oha_mq_get_status(struct oha_mq * mq, struct oha_lpht_status * status);
+
+/**********************************************************************************************************************
+ *  bounded cache (cache)
+ *
+ *      - lpht with a fixed number of elements, inserts into the full table evict an element by CLOCK
+ *      - one reference byte per bucket instead of list pointers, look ups only set the byte of the hit
+ *      - new elements start unreferenced, so keys that are never looked up again are evicted first
+ *
+ **********************************************************************************************************************/
+struct oha_cache;
+
+/*
+ * Is called for every evicted element before it is removed. The value memory is released after the call and the
+ * cache must not be modified by the callback.
+ */
+typedef void (*oha_cache_evicted_fp)(const void * key, void * value, void * ctx);
+
+struct oha_cache_config {
+    /*
+     * The table is never resized, max_elems is the capacity of the cache.
+     */
+    struct oha_lpht_config table_config;
+    oha_cache_evicted_fp evicted; // optional
+    void * evicted_ctx;
+};
+
+struct oha_cache_status {
+    uint32_t max_elems;
+    uint32_t elems_in_use;
+    size_t size_in_bytes;
+    uint64_t hits;      // look ups of keys in the cache
+    uint64_t misses;    // look ups of keys not in the cache
+    uint64_t evictions; // elements evicted by inserts
+};
+
+OHA_PUBLIC_API struct oha_cache *
+oha_cache_create(const struct oha_cache_config * config);
+OHA_PUBLIC_API void
+oha_cache_destroy(struct oha_cache * cache);
+/*
+ * Marks the element as referenced, it survives the next pass of the clock hand.
+ */
+OHA_PUBLIC_API void *
+oha_cache_look_up(struct oha_cache * cache, const void * key);
+/*
+ * Returns the value of the inserted key or of the key already in the cache. If the cache is full, another element is
+ * evicted for a new key. A key which exceeds the max_probe_length of the table is rejected with NULL and evicts nothing.
+ */
+OHA_PUBLIC_API void *
+oha_cache_insert(struct oha_cache * cache, const void * key);
+OHA_PUBLIC_API void *
+oha_cache_remove(struct oha_cache * cache, const void * key);
+OHA_PUBLIC_API int
+oha_cache_get_status(const struct oha_cache * cache, struct oha_cache_status * status);
+
+/**********************************************************************************************************************
+ *  hierarchical timing wheel (htw)
+ *
+ *      - timers are identified by their key in a lpht, the value of a key is the user data of its timer
+ *      - start, stop and restart by key in O(1), the expiry ticks are ordered by a hierarchy of wheels
+ *      - advancing the time touches only the slots which contain timers
+ *
+ **********************************************************************************************************************/
+struct oha_htw;
+
+struct oha_htw_config {
+    /*
+     * The value size is the size of the user data, the table adds the timer.
+     */
+    struct oha_lpht_config table_config;
+    uint64_t now; // start time of the wheel in ticks
+};
+
+/*
+ * Is called for every expired timer. The value memory is released after the call and the wheel must not be modified
+ * by the callback.
+ */
+typedef void (*oha_htw_expired_fp)(const void * key, void * value, void * ctx);
+
+OHA_PUBLIC_API struct oha_htw *
+oha_htw_create(const struct oha_htw_config * config);
+OHA_PUBLIC_API void
+oha_htw_destroy(struct oha_htw * wheel);
+/*
+ * Starts the timer of the key or restarts it if it is already running. Returns the user data of the timer.
+ * A timer which expires not after the current time expires with the next advance to a later time.
+ */
+OHA_PUBLIC_API void *
+oha_htw_start(struct oha_htw * wheel, const void * key, uint64_t expires);
+/*
+ * Stops the timer of the key. The returned value memory stays valid until the next start of a timer.
+ */
+OHA_PUBLIC_API void *
+oha_htw_stop(struct oha_htw * wheel, const void * key);
+OHA_PURE OHA_PUBLIC_API void *
+oha_htw_look_up(const struct oha_htw * wheel, const void * key);
+/*
+ * 'value' is a value returned by the start or look up function.
+ */
+OHA_PURE OHA_PUBLIC_API uint64_t
+oha_htw_get_expiry(const struct oha_htw * wheel, const void * value);
+/*
+ * Advances the time to 'now' and passes all timers, which expire until then, to the optional callback.
+ * Returns the number of expired timers.
+ */
+OHA_PUBLIC_API uint32_t
+oha_htw_advance(struct oha_htw * wheel, uint64_t now, oha_htw_expired_fp callback, void * ctx);
+OHA_PUBLIC_API int
+oha_htw_get_status(const struct oha_htw * wheel, struct oha_lpht_status * status);
+
 // include all code as static inline functions
 #ifdef OHA_INLINE_ALL
 #include "oha_lpht_impl.h"
+#include "oha_bh_impl.h"
+#include "oha_rxh_impl.h"
+#include "oha_tpht_impl.h"
+#include "oha_mq_impl.h"
+#include "oha_cache_impl.h"
+#include "oha_htw_impl.h"
 #endif
 
 #ifdef __cplusplus
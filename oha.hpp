@@ -0,0 +1,454 @@
+#ifndef OHA_ORDERED_HASHING_HPP_
+#define OHA_ORDERED_HASHING_HPP_
+
+/*
+ * Typed C++ wrapper of the linear probing hash table (lpht), build on the header only variant.
+ *
+ *  - keys are copied, hashed and compared bytewise by the C implementation, so the key type must be trivially
+ *    copyable and must not contain padding bytes or members with multiple representations of the same value
+ *  - values are constructed in place and never moved by the table, pointers and references stay valid until the
+ *    element is erased, also across resizes
+ *  - the underlying table is shared with C code by native(), as long as both use the same compile definitions
+ *  - iterators visit the elements in bucket order, also if the table is insertion ordered
+ *  - the probing uses the compile time key size, tracing and the other table options work like in the C API
+ */
+
+#if defined(OHA_ORDERED_HASHING_H_) && !defined(OHA_INLINE_ALL)
+#error "oha.hpp needs the header only variant, include it before oha.h or define OHA_INLINE_ALL"
+#endif
+
+#include "oha_ho.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace oha {
+
+template <typename K, typename V>
+class lpht {
+    static_assert(std::is_trivially_copyable<K>::value, "keys are copied bytewise");
+#if __cplusplus >= 201703L
+    static_assert(std::has_unique_object_representations<K>::value, "keys are compared bytewise");
+#endif
+    static_assert(alignof(K) <= SIZE_T_WIDTH, "key buckets are only aligned to the size of size_t");
+    static_assert(alignof(V) <= SIZE_T_WIDTH, "value buckets are only aligned to the size of size_t");
+
+    // the table needs at least 4 byte keys, smaller keys are stored zero padded
+    static constexpr size_t key_size = sizeof(K) < sizeof(uint32_t) ? sizeof(uint32_t) : sizeof(K);
+
+    struct key_buffer {
+        unsigned char bytes[key_size];
+
+        explicit key_buffer(const K & key)
+        {
+            std::memset(bytes, 0, sizeof(bytes));
+            std::memcpy(bytes, &key, sizeof(K));
+        }
+    };
+
+    template <bool Const>
+    class basic_iterator {
+        friend class lpht;
+        template <bool>
+        friend class basic_iterator;
+        using table_ptr = const struct oha_lpht *;
+        using mapped_ref = typename std::conditional<Const, const V &, V &>::type;
+
+        table_ptr table;
+        struct oha_lpht_key_bucket * bucket;
+
+        basic_iterator(table_ptr t, struct oha_lpht_key_bucket * b) : table(t), bucket(b)
+        {
+        }
+
+        void
+        skip_empty()
+        {
+            while (bucket <= table->last_key_bucket && !i_oha_lpht_is_occupied(bucket)) {
+                bucket = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(bucket, table->key_bucket_size);
+            }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const K &, mapped_ref>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        struct pointer {
+            value_type pair;
+            const value_type *
+            operator->() const
+            {
+                return &pair;
+            }
+        };
+
+        basic_iterator() : table(NULL), bucket(NULL)
+        {
+        }
+
+        // iterator -> const_iterator
+        template <bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        basic_iterator(const basic_iterator<OtherConst> & other) : table(other.table), bucket(other.bucket)
+        {
+        }
+
+        const K &
+        key() const
+        {
+            return *reinterpret_cast<const K *>(bucket->key_buffer);
+        }
+
+        mapped_ref
+        value() const
+        {
+            return *static_cast<V *>(i_oha_lpht_get_value(table, bucket));
+        }
+
+        reference operator*() const
+        {
+            return reference(key(), value());
+        }
+
+        pointer operator->() const
+        {
+            return pointer{reference(key(), value())};
+        }
+
+        basic_iterator &
+        operator++()
+        {
+            bucket = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(bucket, table->key_bucket_size);
+            skip_empty();
+            return *this;
+        }
+
+        basic_iterator
+        operator++(int)
+        {
+            basic_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool
+        operator==(const basic_iterator & other) const
+        {
+            return bucket == other.bucket;
+        }
+
+        bool
+        operator!=(const basic_iterator & other) const
+        {
+            return bucket != other.bucket;
+        }
+    };
+
+    template <typename Predicate>
+    static bool
+    erase_if_trampoline(const void * key, void * value, void * ctx)
+    {
+        Predicate & predicate = *static_cast<Predicate *>(ctx);
+        V & typed_value = *static_cast<V *>(value);
+        if (!predicate(*static_cast<const K *>(key), typed_value)) {
+            return false;
+        }
+        typed_value.~V();
+        return true;
+    }
+
+    struct oha_lpht * table;
+
+  public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    static struct oha_lpht_config
+    default_config()
+    {
+        struct oha_lpht_config config;
+        std::memset(&config, 0, sizeof(config));
+        config.max_elems = 16;
+        config.max_load_factor = 0.7f;
+        config.resizable = true;
+        return config;
+    }
+
+    /*
+     * The key and value size of the config are set by the wrapper. Throws std::bad_alloc if the table could not
+     * be created.
+     */
+    explicit lpht(struct oha_lpht_config config = default_config())
+    {
+        config.key_size = key_size;
+        config.value_size = sizeof(V);
+        table = oha_lpht_create(&config);
+        if (table == NULL) {
+            throw std::bad_alloc();
+        }
+    }
+
+    lpht(const lpht &) = delete;
+    lpht &
+    operator=(const lpht &) = delete;
+
+    lpht(lpht && other) noexcept : table(other.table)
+    {
+        other.table = NULL;
+    }
+
+    lpht &
+    operator=(lpht && other) noexcept
+    {
+        std::swap(table, other.table);
+        return *this;
+    }
+
+    ~lpht()
+    {
+        if (table != NULL) {
+            destroy_values();
+            oha_lpht_destroy(table);
+        }
+    }
+
+    iterator
+    begin()
+    {
+        iterator it(table, table->key_buckets);
+        it.skip_empty();
+        return it;
+    }
+
+    iterator
+    end()
+    {
+        return iterator(table, end_bucket());
+    }
+
+    const_iterator
+    begin() const
+    {
+        const_iterator it(table, table->key_buckets);
+        it.skip_empty();
+        return it;
+    }
+
+    const_iterator
+    end() const
+    {
+        return const_iterator(table, end_bucket());
+    }
+
+    size_type
+    size() const
+    {
+        return table->elems;
+    }
+
+    bool
+    empty() const
+    {
+        return table->elems == 0;
+    }
+
+    iterator
+    find(const K & key)
+    {
+        struct oha_lpht_key_bucket * bucket = look_up(key);
+        return iterator(table, bucket != NULL ? bucket : end_bucket());
+    }
+
+    const_iterator
+    find(const K & key) const
+    {
+        struct oha_lpht_key_bucket * bucket = look_up(key);
+        return const_iterator(table, bucket != NULL ? bucket : end_bucket());
+    }
+
+    bool
+    contains(const K & key) const
+    {
+        if (sizeof(K) < key_size) {
+            const key_buffer buffer(key);
+            return contains_bytes(buffer.bytes);
+        }
+        return contains_bytes(&key);
+    }
+
+    /*
+     * Constructs the value from 'args' if the key is not in the table, otherwise the arguments are not touched.
+     * Returns the element and true if it was inserted. Throws std::bad_alloc if the table could not grow.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool>
+    emplace(const K & key, Args &&... args)
+    {
+        bool inserted = false;
+        struct oha_lpht_key_bucket * bucket;
+        if (sizeof(K) < key_size) {
+            const key_buffer buffer(key);
+            bucket = insert_bytes(buffer.bytes, &inserted);
+        } else {
+            bucket = insert_bytes(&key, &inserted);
+        }
+        if (bucket == NULL) {
+            throw std::bad_alloc();
+        }
+        if (inserted) {
+            void * const value = i_oha_lpht_get_value(table, bucket);
+            try {
+                new (value) V(std::forward<Args>(args)...);
+            } catch (...) {
+                (void)i_oha_lpht_remove_bucket(table, bucket);
+                throw;
+            }
+        }
+        return std::make_pair(iterator(table, bucket), inserted);
+    }
+
+    V & operator[](const K & key)
+    {
+        return emplace(key).first.value();
+    }
+
+    size_type
+    erase(const K & key)
+    {
+        void * value;
+        if (sizeof(K) < key_size) {
+            const key_buffer buffer(key);
+            value = remove_bytes(buffer.bytes);
+        } else {
+            value = remove_bytes(&key);
+        }
+        if (value == NULL) {
+            return 0;
+        }
+        // the value bucket is only reused by the next insert
+        static_cast<V *>(value)->~V();
+        return 1;
+    }
+
+    /*
+     * Erases all elements for which 'predicate(key, value)' returns true in a single pass.
+     */
+    template <typename Predicate>
+    size_type
+    erase_if(Predicate predicate)
+    {
+        return oha_lpht_erase_if_int(table, erase_if_trampoline<Predicate>, &predicate);
+    }
+
+    void
+    clear()
+    {
+        destroy_values();
+        oha_lpht_clear_int(table);
+    }
+
+    /*
+     * Returns false if the table is not resizable or the memory could not be allocated.
+     */
+    bool
+    reserve(uint32_t elements)
+    {
+        return oha_lpht_reserve(table, elements) == 0;
+    }
+
+    struct oha_lpht *
+    native()
+    {
+        return table;
+    }
+
+    const struct oha_lpht *
+    native() const
+    {
+        return table;
+    }
+
+  private:
+    struct oha_lpht_key_bucket *
+    end_bucket() const
+    {
+        return (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(table->last_key_bucket, table->key_bucket_size);
+    }
+
+    struct oha_lpht_key_bucket *
+    look_up(const K & key) const
+    {
+        if (sizeof(K) < key_size) {
+            const key_buffer buffer(key);
+            return look_up_bytes(buffer.bytes);
+        }
+        return look_up_bytes(&key);
+    }
+
+    // the *_bytes functions take the key in the table format, they pass the key size as compile time constant
+    static uint32_t
+    hash(const void * key)
+    {
+        return oha_lpht_hash_32bit(key, key_size);
+    }
+
+    bool
+    contains_bytes(const void * key) const
+    {
+#ifdef OHA_WITH_TRACE_SUPPORT
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_LOOK_UP, key);
+#endif
+        return i_oha_lpht_contains_sized(table, key, hash(key), key_size);
+    }
+
+    struct oha_lpht_key_bucket *
+    look_up_bytes(const void * key) const
+    {
+#ifdef OHA_WITH_TRACE_SUPPORT
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_LOOK_UP, key);
+#endif
+        return i_oha_lpht_look_up_sized(table, key, hash(key), key_size);
+    }
+
+    struct oha_lpht_key_bucket *
+    insert_bytes(const void * key, bool * inserted)
+    {
+#ifdef OHA_WITH_TRACE_SUPPORT
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_INSERT, key);
+#endif
+        return i_oha_lpht_insert_sized(table, key, hash(key), key_size, inserted);
+    }
+
+    void *
+    remove_bytes(const void * key)
+    {
+#ifdef OHA_WITH_TRACE_SUPPORT
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_REMOVE, key);
+#endif
+        return i_oha_lpht_remove_sized(table, key, hash(key), key_size);
+    }
+
+    void
+    destroy_values()
+    {
+        if (std::is_trivially_destructible<V>::value) {
+            return;
+        }
+        for (uint32_t i = i_oha_lpht_next_occupied(table, 0); i < table->max_indicies;
+             i = i_oha_lpht_next_occupied(table, i + 1)) {
+            static_cast<V *>(i_oha_lpht_get_value(table, i_oha_lpht_get_bucket(table, i)))->~V();
+        }
+    }
+};
+
+} // namespace oha
+
+#endif
@@ -0,0 +1,729 @@
+#ifndef OHA_BINARY_HEAP_H_
+#define OHA_BINARY_HEAP_H_
+
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oha_utils.h"
+
+#define OHA_BH_CACHE_LINE_SIZE 64
+#define OHA_BH_MAX_ARITY (OHA_BH_CACHE_LINE_SIZE / sizeof(int64_t))
+// elements removed by one pass of the batch extraction, bounds its stack memory
+#define OHA_BH_BATCH_SIZE 64
+
+// stored in front of every value to find the node of a value in O(1)
+struct oha_bh_value_bucket {
+    uint32_t node_index;
+};
+
+struct oha_bh {
+    struct oha_memory_fp memory;
+    struct oha_memory_pool value_pool;
+    /*
+     * The nodes [0, elems) are heap ordered, the nodes [elems, max_elems) keep the free value buckets, so a removed
+     * value bucket is reused by the next insert. The keys are separated from the value buckets to compare all
+     * children of a node within a single cache line: the key array starts arity - 1 keys in front of a cache line,
+     * so the first child of every node starts a cache line.
+     */
+    int64_t * keys;
+    struct oha_bh_value_bucket ** value_buckets;
+    void * keys_allocation;   // unaligned begin of the key array
+    size_t value_bucket_size; // size in bytes of one value bucket including the header, memory aligned
+    uint32_t elems;
+    uint32_t max_elems;
+    uint8_t arity_log2;
+    bool resizable;
+};
+
+OHA_FORCE_INLINE void *
+i_oha_bh_get_value(struct oha_bh_value_bucket * const bucket)
+{
+    return oha_move_ptr_num_bytes(bucket, OHA_ALIGN_UP(sizeof(struct oha_bh_value_bucket)));
+}
+
+OHA_FORCE_INLINE struct oha_bh_value_bucket *
+i_oha_bh_get_value_bucket(const void * const value)
+{
+    return (struct oha_bh_value_bucket *)((const uint8_t *)value - OHA_ALIGN_UP(sizeof(struct oha_bh_value_bucket)));
+}
+
+OHA_FORCE_INLINE void
+i_oha_bh_set_node(struct oha_bh * const heap,
+                  const uint32_t index,
+                  const int64_t key,
+                  struct oha_bh_value_bucket * const bucket)
+{
+    heap->keys[index] = key;
+    heap->value_buckets[index] = bucket;
+    bucket->node_index = index;
+}
+
+// returns the node index of the value or UINT32_MAX if the value is not in the heap
+OHA_FORCE_INLINE uint32_t
+i_oha_bh_node_index_of_value(const struct oha_bh * const heap, const void * const value)
+{
+    const struct oha_bh_value_bucket * const bucket = i_oha_bh_get_value_bucket(value);
+    const uint32_t index = bucket->node_index;
+    if (index >= heap->elems || heap->value_buckets[index] != bucket) {
+        return UINT32_MAX;
+    }
+    return index;
+}
+
+OHA_FORCE_INLINE void
+i_oha_bh_sift_up(struct oha_bh * const heap, uint32_t index)
+{
+    const int64_t key = heap->keys[index];
+    struct oha_bh_value_bucket * const bucket = heap->value_buckets[index];
+    while (index > 0) {
+        const uint32_t parent = (index - 1) >> heap->arity_log2;
+        if (heap->keys[parent] <= key) {
+            break;
+        }
+        i_oha_bh_set_node(heap, index, heap->keys[parent], heap->value_buckets[parent]);
+        index = parent;
+    }
+    i_oha_bh_set_node(heap, index, key, bucket);
+}
+
+OHA_FORCE_INLINE void
+i_oha_bh_sift_down(struct oha_bh * const heap, uint32_t index)
+{
+    const int64_t key = heap->keys[index];
+    struct oha_bh_value_bucket * const bucket = heap->value_buckets[index];
+    for (;;) {
+        const uint64_t first_child = ((uint64_t)index << heap->arity_log2) + 1;
+        if (first_child >= heap->elems) {
+            break;
+        }
+        // the children are in one cache line, only the key of the smallest child is compared with the sifted key
+        const uint32_t end = (uint32_t)OMA_MIN(first_child + (UINT64_C(1) << heap->arity_log2), heap->elems);
+        uint32_t min_child = (uint32_t)first_child;
+        for (uint32_t child = min_child + 1; child < end; child++) {
+            if (heap->keys[child] < heap->keys[min_child]) {
+                min_child = child;
+            }
+        }
+        if (key <= heap->keys[min_child]) {
+            break;
+        }
+        i_oha_bh_set_node(heap, index, heap->keys[min_child], heap->value_buckets[min_child]);
+        index = min_child;
+    }
+    i_oha_bh_set_node(heap, index, key, bucket);
+}
+
+// connects the nodes [first, first + num) with the value buckets of a new buffer
+OHA_FORCE_INLINE void
+i_oha_bh_connect_value_buckets(struct oha_bh * const heap, uint8_t * const data, const uint32_t first, uint32_t num)
+{
+    for (uint32_t i = 0; i < num; i++) {
+        struct oha_bh_value_bucket * const bucket =
+            (struct oha_bh_value_bucket *)oha_move_ptr_num_bytes(data, heap->value_bucket_size * i);
+        bucket->node_index = first + i;
+        heap->value_buckets[first + i] = bucket;
+    }
+}
+
+// allocates a key array for max_elems keys, the first child of every node starts a cache line
+OHA_FORCE_INLINE int64_t *
+i_oha_bh_alloc_keys(const struct oha_bh * const heap, const uint32_t max_elems, void ** const allocation)
+{
+    const size_t padding = (UINT32_C(1) << heap->arity_log2) - 1;
+    *allocation = oha_malloc(&heap->memory, (padding + max_elems) * sizeof(int64_t) + OHA_BH_CACHE_LINE_SIZE);
+    if (*allocation == NULL) {
+        return NULL;
+    }
+    const uintptr_t aligned =
+        ((uintptr_t)*allocation + OHA_BH_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(OHA_BH_CACHE_LINE_SIZE - 1);
+    return (int64_t *)aligned + padding;
+}
+
+OHA_FORCE_INLINE void
+i_oha_bh_clean_up(struct oha_bh * const heap)
+{
+    assert(heap);
+    const struct oha_memory_fp * memory = &heap->memory;
+
+    if (heap->keys_allocation != NULL) {
+        oha_free(memory, heap->keys_allocation);
+    }
+    if (heap->value_buckets != NULL) {
+        oha_free(memory, heap->value_buckets);
+    }
+    for (size_t i = 0; i < heap->value_pool.elems; i++) {
+        oha_free(memory, heap->value_pool.buffers[i].data);
+    }
+    if (heap->value_pool.buffers != NULL) {
+        oha_free(memory, heap->value_pool.buffers);
+    }
+}
+
+OHA_FORCE_INLINE int
+i_oha_bh_init_heap(struct oha_bh * const heap)
+{
+    const struct oha_memory_fp * memory = &heap->memory;
+    heap->keys = i_oha_bh_alloc_keys(heap, heap->max_elems, &heap->keys_allocation);
+    if (heap->keys == NULL) {
+        return -1;
+    }
+    heap->value_buckets = (struct oha_bh_value_bucket **)oha_malloc(
+        memory, sizeof(struct oha_bh_value_bucket *) * heap->max_elems);
+    if (heap->value_buckets == NULL) {
+        i_oha_bh_clean_up(heap);
+        return -4;
+    }
+
+    heap->value_pool.buffers = (struct oha_buffer *)oha_malloc(memory, sizeof(*heap->value_pool.buffers));
+    if (heap->value_pool.buffers == NULL) {
+        i_oha_bh_clean_up(heap);
+        return -2;
+    }
+
+    uint8_t * const data = (uint8_t *)oha_malloc(memory, heap->value_bucket_size * heap->max_elems);
+    if (data == NULL) {
+        i_oha_bh_clean_up(heap);
+        return -3;
+    }
+    heap->value_pool.buffers[0].data = data;
+    heap->value_pool.elems = 1;
+    i_oha_bh_connect_value_buckets(heap, data, 0, heap->max_elems);
+    return 0;
+}
+
+// doubles the number of nodes, the value buckets of the old buffers are not moved
+OHA_PRIVATE_API int
+i_oha_bh_grow(struct oha_bh * const heap)
+{
+    if (!heap->resizable) {
+        return -1;
+    }
+    if (heap->max_elems > UINT32_MAX / 2) {
+        return -2;
+    }
+
+    const struct oha_memory_fp * memory = &heap->memory;
+    const uint32_t max_elems = 2 * heap->max_elems;
+    const uint32_t new_elems = max_elems - heap->max_elems;
+
+    uint8_t * const data = (uint8_t *)oha_malloc(memory, heap->value_bucket_size * new_elems);
+    if (data == NULL) {
+        return -3;
+    }
+
+    // the aligned key array can not be reallocated, the realloc could change the alignment
+    void * keys_allocation;
+    int64_t * const keys = i_oha_bh_alloc_keys(heap, max_elems, &keys_allocation);
+    if (keys == NULL) {
+        oha_free(memory, data);
+        return -6;
+    }
+
+    struct oha_bh_value_bucket ** const value_buckets = (struct oha_bh_value_bucket **)oha_realloc(
+        memory, heap->value_buckets, sizeof(struct oha_bh_value_bucket *) * max_elems);
+    if (value_buckets == NULL) {
+        oha_free(memory, keys_allocation);
+        oha_free(memory, data);
+        return -4;
+    }
+    heap->value_buckets = value_buckets;
+
+    size_t num_buffers = heap->value_pool.elems;
+    if (!oha_add_entry_to_array(
+            memory, (void **)&heap->value_pool.buffers, sizeof(*heap->value_pool.buffers), &num_buffers)) {
+        // the larger value bucket array is kept for the next try
+        oha_free(memory, keys_allocation);
+        oha_free(memory, data);
+        return -5;
+    }
+    heap->value_pool.buffers[heap->value_pool.elems].data = data;
+    heap->value_pool.elems = num_buffers;
+
+    memcpy(keys, heap->keys, sizeof(int64_t) * heap->elems);
+    oha_free(memory, heap->keys_allocation);
+    heap->keys = keys;
+    heap->keys_allocation = keys_allocation;
+
+    i_oha_bh_connect_value_buckets(heap, data, heap->max_elems, new_elems);
+    heap->max_elems = max_elems;
+    return 0;
+}
+
+// removes the node and keeps its value bucket behind the heap nodes for the next insert
+OHA_FORCE_INLINE void
+i_oha_bh_remove_node(struct oha_bh * const heap, const uint32_t index)
+{
+    assert(index < heap->elems);
+    const int64_t removed_key = heap->keys[index];
+    struct oha_bh_value_bucket * const removed_bucket = heap->value_buckets[index];
+    heap->elems--;
+    const uint32_t last = heap->elems;
+    const int64_t last_key = heap->keys[last];
+    struct oha_bh_value_bucket * const last_bucket = heap->value_buckets[last];
+    heap->value_buckets[last] = removed_bucket;
+    if (index == last) {
+        return;
+    }
+
+    i_oha_bh_set_node(heap, index, last_key, last_bucket);
+    if (last_key < removed_key) {
+        i_oha_bh_sift_up(heap, index);
+    } else {
+        i_oha_bh_sift_down(heap, index);
+    }
+}
+
+/*
+ * Fills the hole at 'top' with the key, whose subtrees are heap ordered. The hole is moved down to a leaf without
+ * comparisons with the key, because a key from the end of the heap belongs most likely into the lowest level
+ * anyway, the key is sifted up from there, but not above 'top'.
+ */
+OHA_FORCE_INLINE void
+i_oha_bh_fill_hole(struct oha_bh * const heap,
+                   const uint32_t top,
+                   const int64_t key,
+                   struct oha_bh_value_bucket * const bucket)
+{
+    uint32_t index = top;
+    for (;;) {
+        const uint64_t first_child = ((uint64_t)index << heap->arity_log2) + 1;
+        if (first_child >= heap->elems) {
+            break;
+        }
+        const uint32_t end = (uint32_t)OMA_MIN(first_child + (UINT64_C(1) << heap->arity_log2), heap->elems);
+        uint32_t min_child = (uint32_t)first_child;
+        for (uint32_t child = min_child + 1; child < end; child++) {
+            if (heap->keys[child] < heap->keys[min_child]) {
+                min_child = child;
+            }
+        }
+        i_oha_bh_set_node(heap, index, heap->keys[min_child], heap->value_buckets[min_child]);
+        index = min_child;
+    }
+    while (index > top) {
+        const uint32_t parent = (index - 1) >> heap->arity_log2;
+        if (heap->keys[parent] <= key) {
+            break;
+        }
+        i_oha_bh_set_node(heap, index, heap->keys[parent], heap->value_buckets[parent]);
+        index = parent;
+    }
+    i_oha_bh_set_node(heap, index, key, bucket);
+}
+
+// removes the root and fills its hole with the last node
+OHA_FORCE_INLINE struct oha_bh_value_bucket *
+i_oha_bh_remove_min(struct oha_bh * const heap)
+{
+    assert(heap->elems > 0);
+    struct oha_bh_value_bucket * const removed_bucket = heap->value_buckets[0];
+    heap->elems--;
+    const uint32_t last = heap->elems;
+    const int64_t last_key = heap->keys[last];
+    struct oha_bh_value_bucket * const last_bucket = heap->value_buckets[last];
+    heap->value_buckets[last] = removed_bucket;
+    if (last == 0) {
+        return removed_bucket;
+    }
+    i_oha_bh_fill_hole(heap, 0, last_key, last_bucket);
+    return removed_bucket;
+}
+
+// restores the heap order of all nodes bottom up in O(n)
+OHA_FORCE_INLINE void
+i_oha_bh_heapify(struct oha_bh * const heap)
+{
+    if (heap->elems < 2) {
+        return;
+    }
+    for (uint32_t parent = ((heap->elems - 2) >> heap->arity_log2) + 1; parent > 0; parent--) {
+        i_oha_bh_sift_down(heap, parent - 1);
+    }
+}
+
+/*
+ * Removes up to 'num' (at most OHA_BH_BATCH_SIZE) elements with a key less than or equal to 'max_key' and stores
+ * their value buckets in 'buckets', not ordered by their keys. The due nodes form a subtree at the root, which is
+ * collected breadth first. Its holes are filled with the last nodes and repaired bottom up, like a heapify of the
+ * subtree, so the top levels are walked once per batch instead of once per element.
+ */
+OHA_FORCE_INLINE uint32_t
+i_oha_bh_remove_due(struct oha_bh * const heap,
+                    const uint32_t num,
+                    const int64_t max_key,
+                    struct oha_bh_value_bucket ** const buckets)
+{
+    assert(num <= OHA_BH_BATCH_SIZE);
+    if (heap->elems == 0 || num == 0 || heap->keys[0] > max_key) {
+        return 0;
+    }
+
+    // the breadth first order visits the nodes in ascending index order, the holes are the queue of the search
+    uint32_t holes[OHA_BH_BATCH_SIZE];
+    holes[0] = 0;
+    uint32_t removed = 1;
+    for (uint32_t next = 0; next < removed && removed < num; next++) {
+        const uint64_t first_child = ((uint64_t)holes[next] << heap->arity_log2) + 1;
+        const uint32_t end = (uint32_t)OMA_MIN(first_child + (UINT64_C(1) << heap->arity_log2), heap->elems);
+        for (uint32_t child = (uint32_t)OMA_MIN(first_child, heap->elems); child < end && removed < num; child++) {
+            if (heap->keys[child] <= max_key) {
+                holes[removed++] = child;
+            }
+        }
+    }
+    if (removed == 1) {
+        buckets[0] = i_oha_bh_remove_min(heap);
+        return 1;
+    }
+    for (uint32_t i = 0; i < removed; i++) {
+        buckets[i] = heap->value_buckets[holes[i]];
+    }
+
+    // every hole in front of the new end gets a not removed node from behind it
+    const uint32_t elems = heap->elems - removed;
+    uint32_t tail = heap->elems;
+    uint32_t tail_holes = removed;
+    uint32_t inner_holes = 0;
+    for (; inner_holes < removed && holes[inner_holes] < elems; inner_holes++) {
+        for (tail--; tail_holes > inner_holes && holes[tail_holes - 1] == tail; tail--) {
+            tail_holes--;
+        }
+        i_oha_bh_set_node(heap, holes[inner_holes], heap->keys[tail], heap->value_buckets[tail]);
+    }
+    // the removed value buckets are reused by the next inserts
+    for (uint32_t i = 0; i < removed; i++) {
+        heap->value_buckets[elems + i] = buckets[i];
+    }
+    heap->elems = elems;
+    while (inner_holes > 0) {
+        const uint32_t hole = holes[--inner_holes];
+        i_oha_bh_fill_hole(heap, hole, heap->keys[hole], heap->value_buckets[hole]);
+    }
+    return removed;
+}
+
+// overwrites the key of a value without restoring the heap order, i_oha_bh_heapify() must follow
+OHA_FORCE_INLINE void
+i_oha_bh_set_key_unordered(struct oha_bh * const heap, const void * const value, const int64_t key)
+{
+    const uint32_t index = i_oha_bh_get_value_bucket(value)->node_index;
+    assert(index < heap->elems);
+    heap->keys[index] = key;
+}
+
+OHA_FORCE_INLINE void
+oha_bh_destroy_int(struct oha_bh * const heap)
+{
+    assert(heap);
+    const struct oha_memory_fp * memory = &heap->memory;
+    i_oha_bh_clean_up(heap);
+    oha_free(memory, heap);
+}
+
+OHA_FORCE_INLINE struct oha_bh *
+oha_bh_create_int(const struct oha_bh_config * const config)
+{
+    assert(config);
+    const uint32_t arity = config->arity == 0 ? 2 : config->arity;
+    if (config->max_elems == 0 || arity < 2 || arity > OHA_BH_MAX_ARITY || (arity & (arity - 1)) != 0) {
+        return NULL;
+    }
+
+    struct oha_bh * const heap = (struct oha_bh *)oha_calloc(&config->memory, sizeof(struct oha_bh));
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    heap->memory = config->memory;
+    heap->value_bucket_size = OHA_ALIGN_UP(sizeof(struct oha_bh_value_bucket)) + OHA_ALIGN_UP(config->value_size);
+    heap->max_elems = config->max_elems;
+    heap->resizable = config->resizable;
+    heap->arity_log2 = (uint8_t)OHA_CTZ64(arity);
+
+    if (0 != i_oha_bh_init_heap(heap)) {
+        oha_free(&config->memory, heap);
+        return NULL;
+    }
+    return heap;
+}
+
+OHA_FORCE_INLINE void *
+oha_bh_find_min_int(const struct oha_bh * const heap, int64_t * const key)
+{
+    assert(heap);
+    if (heap->elems == 0) {
+        return NULL;
+    }
+    if (key != NULL) {
+        *key = heap->keys[0];
+    }
+    return i_oha_bh_get_value(heap->value_buckets[0]);
+}
+
+OHA_FORCE_INLINE void *
+oha_bh_delete_min_int(struct oha_bh * const heap)
+{
+    assert(heap);
+    if (heap->elems == 0) {
+        return NULL;
+    }
+    return i_oha_bh_get_value(i_oha_bh_remove_min(heap));
+}
+
+OHA_FORCE_INLINE void *
+oha_bh_insert_int(struct oha_bh * const heap, const int64_t key)
+{
+    assert(heap);
+    if (heap->elems >= heap->max_elems) {
+        if (i_oha_bh_grow(heap)) {
+            return NULL;
+        }
+    }
+
+    const uint32_t index = heap->elems++;
+    struct oha_bh_value_bucket * const bucket = heap->value_buckets[index];
+    heap->keys[index] = key;
+    i_oha_bh_sift_up(heap, index);
+    return i_oha_bh_get_value(bucket);
+}
+
+OHA_FORCE_INLINE int
+oha_bh_insert_batch_int(struct oha_bh * const heap,
+                        const int64_t * const keys,
+                        const size_t num_keys,
+                        void ** const values)
+{
+    assert(heap && keys && values);
+    if (num_keys > UINT32_MAX - heap->elems) {
+        return -1;
+    }
+    const uint32_t old_elems = heap->elems;
+    const uint32_t elems = old_elems + (uint32_t)num_keys;
+    while (heap->max_elems < elems) {
+        if (i_oha_bh_grow(heap)) {
+            return -1;
+        }
+    }
+
+    for (uint32_t i = 0; i < num_keys; i++) {
+        struct oha_bh_value_bucket * const bucket = heap->value_buckets[old_elems + i];
+        i_oha_bh_set_node(heap, old_elems + i, keys[i], bucket);
+        values[i] = i_oha_bh_get_value(bucket);
+    }
+    heap->elems = elems;
+
+    // a rebuild of the whole heap is cheaper than the sift up of more keys than already in the heap
+    if (num_keys >= old_elems) {
+        i_oha_bh_heapify(heap);
+    } else {
+        for (uint32_t i = old_elems; i < elems; i++) {
+            i_oha_bh_sift_up(heap, i);
+        }
+    }
+    return 0;
+}
+
+OHA_FORCE_INLINE size_t
+oha_bh_delete_min_batch_int(struct oha_bh * const heap, const size_t num, int64_t * const keys, void ** const values)
+{
+    assert(heap && values);
+    const size_t deleted = OMA_MIN(num, (size_t)heap->elems);
+    for (size_t i = 0; i < deleted; i++) {
+        if (keys != NULL) {
+            keys[i] = heap->keys[0];
+        }
+        values[i] = i_oha_bh_get_value(i_oha_bh_remove_min(heap));
+    }
+    return deleted;
+}
+
+OHA_FORCE_INLINE int64_t
+oha_bh_get_key_int(const struct oha_bh * const heap, const void * const value)
+{
+    assert(heap && value);
+    const uint32_t index = i_oha_bh_get_value_bucket(value)->node_index;
+    assert(index < heap->elems);
+    return heap->keys[index];
+}
+
+OHA_FORCE_INLINE int
+oha_bh_change_key_int(struct oha_bh * const heap, void * const value, const int64_t new_key)
+{
+    assert(heap && value);
+    const uint32_t index = i_oha_bh_node_index_of_value(heap, value);
+    if (index == UINT32_MAX) {
+        return -1;
+    }
+
+    const int64_t old_key = heap->keys[index];
+    heap->keys[index] = new_key;
+    if (new_key < old_key) {
+        i_oha_bh_sift_up(heap, index);
+    } else if (new_key > old_key) {
+        i_oha_bh_sift_down(heap, index);
+    }
+    return 0;
+}
+
+OHA_FORCE_INLINE int
+oha_bh_remove_int(struct oha_bh * const heap, void * const value)
+{
+    assert(heap && value);
+    const uint32_t index = i_oha_bh_node_index_of_value(heap, value);
+    if (index == UINT32_MAX) {
+        return -1;
+    }
+    i_oha_bh_remove_node(heap, index);
+    return 0;
+}
+
+OHA_FORCE_INLINE int
+oha_bh_get_status_int(const struct oha_bh * const heap, struct oha_bh_status * const status)
+{
+    assert(heap && status);
+
+    status->max_elems = heap->max_elems;
+    status->elems_in_use = heap->elems;
+    status->size_in_bytes =
+        // keys with the cache line padding, value bucket pointers and value buckets
+        ((UINT32_C(1) << heap->arity_log2) - 1) * sizeof(int64_t) + OHA_BH_CACHE_LINE_SIZE +
+        (sizeof(int64_t) + sizeof(struct oha_bh_value_bucket *) + heap->value_bucket_size) * heap->max_elems +
+        // buffer list of the value pool
+        sizeof(*heap->value_pool.buffers) * heap->value_pool.elems +
+        // heap offset size
+        sizeof(struct oha_bh);
+    return 0;
+}
+
+/**********************************************************************************************************************
+ *
+ * public interface functions section
+ *
+ *********************************************************************************************************************/
+
+OHA_PUBLIC_API struct oha_bh *
+oha_bh_create(const struct oha_bh_config * const config)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (config == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_bh_create_int(config);
+}
+
+OHA_PUBLIC_API void
+oha_bh_destroy(struct oha_bh * const heap)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return;
+    }
+#endif
+    oha_bh_destroy_int(heap);
+}
+
+OHA_PUBLIC_API void *
+oha_bh_find_min(const struct oha_bh * const heap, int64_t * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_bh_find_min_int(heap, key);
+}
+
+OHA_PUBLIC_API void *
+oha_bh_delete_min(struct oha_bh * const heap)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_bh_delete_min_int(heap);
+}
+
+OHA_PUBLIC_API void *
+oha_bh_insert(struct oha_bh * const heap, const int64_t key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_bh_insert_int(heap, key);
+}
+
+OHA_PUBLIC_API int
+oha_bh_insert_batch(struct oha_bh * const heap, const int64_t * const keys, const size_t num_keys, void ** const values)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || keys == NULL || values == NULL) {
+        return -1;
+    }
+#endif
+    return oha_bh_insert_batch_int(heap, keys, num_keys, values);
+}
+
+OHA_PUBLIC_API size_t
+oha_bh_delete_min_batch(struct oha_bh * const heap, const size_t num, int64_t * const keys, void ** const values)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || values == NULL) {
+        return 0;
+    }
+#endif
+    return oha_bh_delete_min_batch_int(heap, num, keys, values);
+}
+
+OHA_PUBLIC_API int64_t
+oha_bh_get_key(const struct oha_bh * const heap, const void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || value == NULL) {
+        return INT64_MAX;
+    }
+#endif
+    return oha_bh_get_key_int(heap, value);
+}
+
+OHA_PUBLIC_API int
+oha_bh_change_key(struct oha_bh * const heap, void * const value, const int64_t new_key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || value == NULL) {
+        return -1;
+    }
+#endif
+    return oha_bh_change_key_int(heap, value, new_key);
+}
+
+OHA_PUBLIC_API int
+oha_bh_remove(struct oha_bh * const heap, void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || value == NULL) {
+        return -1;
+    }
+#endif
+    return oha_bh_remove_int(heap, value);
+}
+
+OHA_PUBLIC_API int
+oha_bh_get_status(const struct oha_bh * const heap, struct oha_bh_status * const status)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || status == NULL) {
+        return -1;
+    }
+#endif
+    return oha_bh_get_status_int(heap, status);
+}
+
+#endif
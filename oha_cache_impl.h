@@ -0,0 +1,266 @@
+#ifndef OHA_BOUNDED_CACHE_H_
+#define OHA_BOUNDED_CACHE_H_
+
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oha_utils.h"
+#include "oha_lpht_impl.h"
+
+struct oha_cache {
+    struct oha_lpht * table;
+    /*
+     * CLOCK reference byte per value bucket, the value bucket of an element does not change if the robin hood
+     * insertion or the back shift moves its key, so the byte follows the element for free
+     */
+    uint8_t * referenced;
+    uint32_t hand; // key bucket index of the clock hand
+    oha_cache_evicted_fp evicted;
+    void * evicted_ctx;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+OHA_FORCE_INLINE uint8_t *
+i_oha_cache_referenced(const struct oha_cache * const cache, const struct oha_lpht_key_bucket * const bucket)
+{
+    // the table is never resized, so all value buckets are in the first buffer
+    assert(bucket->buffer_id == 0);
+    assert(bucket->index < cache->table->max_indicies);
+    return &cache->referenced[bucket->index];
+}
+
+// moves the clock hand to the next unreferenced element and evicts it, the just inserted element is skipped
+OHA_PRIVATE_API void
+i_oha_cache_evict(struct oha_cache * const cache, const struct oha_lpht_key_bucket * const inserted)
+{
+    struct oha_lpht * const table = cache->table;
+    assert(table->elems > 0);
+
+    // every referenced element is cleared on the way, so the hand stops after at most one round
+    uint32_t hand = cache->hand;
+    for (;;) {
+        hand = i_oha_lpht_next_occupied(table, hand);
+        if (hand >= table->max_indicies) {
+            hand = 0;
+            continue;
+        }
+        struct oha_lpht_key_bucket * const bucket = i_oha_lpht_get_bucket(table, hand);
+        if (bucket == inserted) {
+            hand++;
+            continue;
+        }
+        uint8_t * const referenced = i_oha_cache_referenced(cache, bucket);
+        if (*referenced) {
+            *referenced = 0;
+            hand++;
+            continue;
+        }
+
+        if (cache->evicted != NULL) {
+            cache->evicted(bucket->key_buffer, i_oha_lpht_get_value(table, bucket), cache->evicted_ctx);
+        }
+        (void)i_oha_lpht_remove_bucket(table, bucket);
+        i_oha_lpht_filter_removed(table, 1);
+        break;
+    }
+    // the back shift could have moved the next element into the bucket of the evicted one, so the hand stays
+    cache->hand = hand;
+    cache->evictions++;
+}
+
+OHA_FORCE_INLINE void
+oha_cache_destroy_int(struct oha_cache * const cache)
+{
+    assert(cache);
+    const struct oha_memory_fp memory = cache->table->memory;
+    if (cache->referenced != NULL) {
+        oha_free(&memory, cache->referenced);
+    }
+    oha_lpht_destroy_int(cache->table);
+    oha_free(&memory, cache);
+}
+
+OHA_FORCE_INLINE struct oha_cache *
+oha_cache_create_int(const struct oha_cache_config * const config)
+{
+    assert(config);
+    const struct oha_memory_fp * memory = &config->table_config.memory;
+
+    struct oha_cache * const cache = (struct oha_cache *)oha_calloc(memory, sizeof(struct oha_cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    struct oha_lpht_config table_config = config->table_config;
+    table_config.resizable = false;
+    cache->table = oha_lpht_create_int(&table_config);
+    if (cache->table == NULL) {
+        oha_free(memory, cache);
+        return NULL;
+    }
+
+    // an insert into the full cache takes a spare key bucket until it has evicted another element
+    if (cache->table->max_elems >= cache->table->max_indicies) {
+        oha_cache_destroy_int(cache);
+        return NULL;
+    }
+
+    cache->referenced = (uint8_t *)oha_calloc(memory, cache->table->max_indicies);
+    if (cache->referenced == NULL) {
+        oha_cache_destroy_int(cache);
+        return NULL;
+    }
+    cache->evicted = config->evicted;
+    cache->evicted_ctx = config->evicted_ctx;
+    return cache;
+}
+
+OHA_FORCE_INLINE void *
+oha_cache_look_up_int(struct oha_cache * const cache, const void * const key)
+{
+    assert(cache && key);
+    struct oha_lpht_key_bucket * const bucket = oha_lpht_look_up_int(cache->table, key);
+    if (bucket == NULL) {
+        cache->misses++;
+        return NULL;
+    }
+    cache->hits++;
+    *i_oha_cache_referenced(cache, bucket) = 1;
+    return i_oha_lpht_get_value(cache->table, bucket);
+}
+
+OHA_FORCE_INLINE void *
+oha_cache_insert_int(struct oha_cache * const cache, const void * const key)
+{
+    assert(cache && key);
+    struct oha_lpht * const table = cache->table;
+
+    // a full table takes the key into a spare bucket, so a single probe finds an existing key and a new key which does
+    // not fit into its probe window is rejected before another element is evicted
+    const uint32_t max_elems = table->max_elems;
+    if (table->elems >= max_elems) {
+        table->max_elems = max_elems + 1;
+    }
+    bool inserted;
+    struct oha_lpht_key_bucket * const bucket =
+        i_oha_lpht_insert_hashed(table, key, i_oha_lpht_hash_key(table, key), &inserted);
+    table->max_elems = max_elems;
+    if (bucket == NULL) {
+        return NULL;
+    }
+
+    // the value bucket stays, if the eviction moves the key bucket
+    void * const value = i_oha_lpht_get_value(table, bucket);
+    if (inserted) {
+        *i_oha_cache_referenced(cache, bucket) = 0;
+        if (table->elems > max_elems) {
+            i_oha_cache_evict(cache, bucket);
+        }
+    }
+    return value;
+}
+
+OHA_FORCE_INLINE void *
+oha_cache_remove_int(struct oha_cache * const cache, const void * const key)
+{
+    assert(cache && key);
+    // the reference byte of the released value bucket is reset by the next insert
+    return oha_lpht_remove_int(cache->table, key);
+}
+
+OHA_FORCE_INLINE int
+oha_cache_get_status_int(const struct oha_cache * const cache, struct oha_cache_status * const status)
+{
+    assert(cache && status);
+    struct oha_lpht_status table_status;
+    if (oha_lpht_get_status_int(cache->table, &table_status) != 0) {
+        return -1;
+    }
+    status->max_elems = table_status.max_elems;
+    status->elems_in_use = table_status.elems_in_use;
+    status->size_in_bytes = table_status.size_in_bytes + cache->table->max_indicies + sizeof(struct oha_cache);
+    status->hits = cache->hits;
+    status->misses = cache->misses;
+    status->evictions = cache->evictions;
+    return 0;
+}
+
+/**********************************************************************************************************************
+ *
+ * public interface functions section
+ *
+ *********************************************************************************************************************/
+
+OHA_PUBLIC_API struct oha_cache *
+oha_cache_create(const struct oha_cache_config * const config)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (config == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_cache_create_int(config);
+}
+
+OHA_PUBLIC_API void
+oha_cache_destroy(struct oha_cache * const cache)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (cache == NULL) {
+        return;
+    }
+#endif
+    oha_cache_destroy_int(cache);
+}
+
+OHA_PUBLIC_API void *
+oha_cache_look_up(struct oha_cache * const cache, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (cache == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_cache_look_up_int(cache, key);
+}
+
+OHA_PUBLIC_API void *
+oha_cache_insert(struct oha_cache * const cache, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (cache == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_cache_insert_int(cache, key);
+}
+
+OHA_PUBLIC_API void *
+oha_cache_remove(struct oha_cache * const cache, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (cache == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_cache_remove_int(cache, key);
+}
+
+OHA_PUBLIC_API int
+oha_cache_get_status(const struct oha_cache * const cache, struct oha_cache_status * const status)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (cache == NULL || status == NULL) {
+        return -1;
+    }
+#endif
+    return oha_cache_get_status_int(cache, status);
+}
+
+#endif
@@ -0,0 +1,356 @@
+#ifndef OHA_HIERARCHICAL_TIMING_WHEEL_H_
+#define OHA_HIERARCHICAL_TIMING_WHEEL_H_
+
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oha_utils.h"
+#include "oha_lpht_impl.h"
+
+/*
+ * A slot of level n covers 64^n ticks, timers are placed in the lowest level which reaches their expiry and move
+ * one or more levels down, when the slot of their level is due (cascade). Timers behind the last level wait in
+ * the farthest slot of the last level and are placed again by its cascade.
+ */
+#define OHA_HTW_SLOT_BITS 6
+#define OHA_HTW_SLOTS (UINT32_C(1) << OHA_HTW_SLOT_BITS)
+#define OHA_HTW_LEVELS 6
+#define OHA_HTW_MAX_DELTA ((UINT64_C(1) << (OHA_HTW_SLOT_BITS * OHA_HTW_LEVELS)) - 1)
+
+// stored behind the user value in the table, values are never moved, so the slot lists link the values directly
+struct oha_htw_timer {
+    struct oha_htw_timer * next;
+    struct oha_htw_timer * prev; // NULL for the first timer of a slot
+    uint64_t expires;
+    uint16_t slot; // level * OHA_HTW_SLOTS + slot index
+    uint8_t key_buffer[];
+};
+
+struct oha_htw {
+    struct oha_lpht * table;
+    size_t timer_offset; // position of the timer behind the user value in the table value
+    uint64_t now;        // all timers up to this tick are expired
+    uint64_t occupied[OHA_HTW_LEVELS]; // one bit per slot with timers
+    struct oha_htw_timer * slots[OHA_HTW_LEVELS * OHA_HTW_SLOTS];
+};
+
+OHA_FORCE_INLINE struct oha_htw_timer *
+i_oha_htw_get_timer(const struct oha_htw * const wheel, const void * const value)
+{
+    return (struct oha_htw_timer *)oha_move_ptr_num_bytes(value, wheel->timer_offset);
+}
+
+OHA_FORCE_INLINE void *
+i_oha_htw_get_value(const struct oha_htw * const wheel, struct oha_htw_timer * const timer)
+{
+    return (uint8_t *)timer - wheel->timer_offset;
+}
+
+// a timer is never placed before 'earliest', which is the current tick during a cascade and the next tick otherwise
+OHA_FORCE_INLINE void
+i_oha_htw_link(struct oha_htw * const wheel, struct oha_htw_timer * const timer, const uint64_t earliest)
+{
+    uint64_t expires = timer->expires < earliest ? earliest : timer->expires;
+    uint64_t delta = expires - wheel->now;
+    if (delta > OHA_HTW_MAX_DELTA) {
+        delta = OHA_HTW_MAX_DELTA;
+        expires = wheel->now + OHA_HTW_MAX_DELTA;
+    }
+    // 64^level <= delta < 64^(level + 1), so the slot is due after now and not after the expiry
+    const uint32_t level = delta < OHA_HTW_SLOTS ? 0 : (63 - OHA_CLZ64(delta)) / OHA_HTW_SLOT_BITS;
+    const uint32_t index = (expires >> (level * OHA_HTW_SLOT_BITS)) & (OHA_HTW_SLOTS - 1);
+    const uint32_t slot = level * OHA_HTW_SLOTS + index;
+
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = wheel->slots[slot];
+    if (timer->next != NULL) {
+        timer->next->prev = timer;
+    }
+    wheel->slots[slot] = timer;
+    wheel->occupied[level] |= UINT64_C(1) << index;
+}
+
+OHA_FORCE_INLINE void
+i_oha_htw_unlink(struct oha_htw * const wheel, struct oha_htw_timer * const timer)
+{
+    if (timer->next != NULL) {
+        timer->next->prev = timer->prev;
+    }
+    if (timer->prev != NULL) {
+        timer->prev->next = timer->next;
+    } else {
+        wheel->slots[timer->slot] = timer->next;
+        if (timer->next == NULL) {
+            wheel->occupied[timer->slot / OHA_HTW_SLOTS] &= ~(UINT64_C(1) << (timer->slot % OHA_HTW_SLOTS));
+        }
+    }
+}
+
+// empties the slot and returns its list of timers
+OHA_FORCE_INLINE struct oha_htw_timer *
+i_oha_htw_take_slot(struct oha_htw * const wheel, const uint32_t level, const uint32_t index)
+{
+    struct oha_htw_timer * const timers = wheel->slots[level * OHA_HTW_SLOTS + index];
+    wheel->slots[level * OHA_HTW_SLOTS + index] = NULL;
+    wheel->occupied[level] &= ~(UINT64_C(1) << index);
+    return timers;
+}
+
+// returns the next tick after now, which has to expire or cascade a slot, UINT64_MAX if the wheel is empty
+OHA_FORCE_INLINE uint64_t
+i_oha_htw_next_tick(const struct oha_htw * const wheel)
+{
+    uint64_t next = UINT64_MAX;
+    for (uint32_t level = 0; level < OHA_HTW_LEVELS; level++) {
+        const uint64_t bits = wheel->occupied[level];
+        if (bits == 0) {
+            continue;
+        }
+        // the slots of a level are due at the multiples of 64^level, search the first one after now
+        const uint32_t shift = level * OHA_HTW_SLOT_BITS;
+        const uint64_t first = (wheel->now >> shift) + 1;
+        const uint32_t start = first & (OHA_HTW_SLOTS - 1);
+        const uint64_t rotated = start == 0 ? bits : (bits >> start) | (bits << (OHA_HTW_SLOTS - start));
+        const uint64_t tick = (first + OHA_CTZ64(rotated)) << shift;
+        if (tick < next) {
+            next = tick;
+        }
+    }
+    return next;
+}
+
+OHA_FORCE_INLINE void
+oha_htw_destroy_int(struct oha_htw * const wheel)
+{
+    assert(wheel);
+    const struct oha_memory_fp memory = wheel->table->memory;
+    oha_lpht_destroy_int(wheel->table);
+    oha_free(&memory, wheel);
+}
+
+OHA_FORCE_INLINE struct oha_htw *
+oha_htw_create_int(const struct oha_htw_config * const config)
+{
+    assert(config);
+    const struct oha_memory_fp * memory = &config->table_config.memory;
+
+    struct oha_htw * const wheel = (struct oha_htw *)oha_calloc(memory, sizeof(struct oha_htw));
+    if (wheel == NULL) {
+        return NULL;
+    }
+
+    struct oha_lpht_config table_config = config->table_config;
+    wheel->timer_offset = OHA_ALIGN_UP(table_config.value_size);
+    table_config.value_size = wheel->timer_offset + sizeof(struct oha_htw_timer) + table_config.key_size;
+    wheel->table = oha_lpht_create_int(&table_config);
+    if (wheel->table == NULL) {
+        oha_free(memory, wheel);
+        return NULL;
+    }
+    wheel->now = config->now;
+    return wheel;
+}
+
+OHA_FORCE_INLINE void *
+oha_htw_start_int(struct oha_htw * const wheel, const void * const key, const uint64_t expires)
+{
+    assert(wheel && key);
+    struct oha_lpht * const table = wheel->table;
+    bool inserted;
+    struct oha_lpht_key_bucket * const bucket =
+        i_oha_lpht_insert_hashed(table, key, i_oha_lpht_hash_key(table, key), &inserted);
+    if (bucket == NULL) {
+        return NULL;
+    }
+    void * const value = i_oha_lpht_get_value(table, bucket);
+    struct oha_htw_timer * const timer = i_oha_htw_get_timer(wheel, value);
+    if (inserted) {
+        memcpy(timer->key_buffer, key, table->key_size);
+    } else {
+        i_oha_htw_unlink(wheel, timer);
+    }
+    timer->expires = expires;
+    i_oha_htw_link(wheel, timer, wheel->now + 1);
+    return value;
+}
+
+OHA_FORCE_INLINE void *
+oha_htw_stop_int(struct oha_htw * const wheel, const void * const key)
+{
+    assert(wheel && key);
+    void * const value = oha_lpht_remove_int(wheel->table, key);
+    if (value == NULL) {
+        return NULL;
+    }
+    i_oha_htw_unlink(wheel, i_oha_htw_get_timer(wheel, value));
+    return value;
+}
+
+OHA_FORCE_INLINE void *
+oha_htw_look_up_int(const struct oha_htw * const wheel, const void * const key)
+{
+    assert(wheel && key);
+    const struct oha_lpht_key_bucket * const bucket = oha_lpht_look_up_int(wheel->table, key);
+    if (bucket == NULL) {
+        return NULL;
+    }
+    return i_oha_lpht_get_value(wheel->table, bucket);
+}
+
+OHA_FORCE_INLINE uint32_t
+oha_htw_advance_int(struct oha_htw * const wheel,
+                    const uint64_t now,
+                    const oha_htw_expired_fp callback,
+                    void * const ctx)
+{
+    assert(wheel);
+    uint32_t expired = 0;
+    // jumps from one due slot to the next one, the ticks between them are not visited
+    for (uint64_t tick = i_oha_htw_next_tick(wheel); tick <= now; tick = i_oha_htw_next_tick(wheel)) {
+        wheel->now = tick;
+
+        // the higher levels first, their timers could move down to the level 0 slot of this tick
+        for (uint32_t level = OHA_HTW_LEVELS - 1; level > 0; level--) {
+            const uint32_t shift = level * OHA_HTW_SLOT_BITS;
+            if ((tick & ((UINT64_C(1) << shift) - 1)) != 0) {
+                continue;
+            }
+            struct oha_htw_timer * timer = i_oha_htw_take_slot(wheel, level, (tick >> shift) & (OHA_HTW_SLOTS - 1));
+            while (timer != NULL) {
+                struct oha_htw_timer * const next = timer->next;
+                i_oha_htw_link(wheel, timer, tick);
+                timer = next;
+            }
+        }
+
+        struct oha_htw_timer * timer = i_oha_htw_take_slot(wheel, 0, tick & (OHA_HTW_SLOTS - 1));
+        while (timer != NULL) {
+            struct oha_htw_timer * const next = timer->next;
+            assert(timer->expires <= tick);
+            // the key copy and the value stay valid until the next start
+            void * const value = oha_lpht_remove_int(wheel->table, timer->key_buffer);
+            assert(value == i_oha_htw_get_value(wheel, timer));
+            if (callback != NULL) {
+                callback(timer->key_buffer, value, ctx);
+            }
+            expired++;
+            timer = next;
+        }
+    }
+    if (now > wheel->now) {
+        wheel->now = now;
+    }
+    return expired;
+}
+
+OHA_FORCE_INLINE int
+oha_htw_get_status_int(const struct oha_htw * const wheel, struct oha_lpht_status * const status)
+{
+    assert(wheel && status);
+    if (oha_lpht_get_status_int(wheel->table, status) != 0) {
+        return -1;
+    }
+    status->size_in_bytes += sizeof(struct oha_htw);
+    return 0;
+}
+
+/**********************************************************************************************************************
+ *
+ * public interface functions section
+ *
+ *********************************************************************************************************************/
+
+OHA_PUBLIC_API struct oha_htw *
+oha_htw_create(const struct oha_htw_config * const config)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (config == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_htw_create_int(config);
+}
+
+OHA_PUBLIC_API void
+oha_htw_destroy(struct oha_htw * const wheel)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL) {
+        return;
+    }
+#endif
+    oha_htw_destroy_int(wheel);
+}
+
+OHA_PUBLIC_API void *
+oha_htw_start(struct oha_htw * const wheel, const void * const key, const uint64_t expires)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_htw_start_int(wheel, key, expires);
+}
+
+OHA_PUBLIC_API void *
+oha_htw_stop(struct oha_htw * const wheel, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_htw_stop_int(wheel, key);
+}
+
+OHA_PUBLIC_API void *
+oha_htw_look_up(const struct oha_htw * const wheel, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_htw_look_up_int(wheel, key);
+}
+
+OHA_PUBLIC_API uint64_t
+oha_htw_get_expiry(const struct oha_htw * const wheel, const void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL || value == NULL) {
+        return UINT64_MAX;
+    }
+#endif
+    return i_oha_htw_get_timer(wheel, value)->expires;
+}
+
+OHA_PUBLIC_API uint32_t
+oha_htw_advance(struct oha_htw * const wheel, const uint64_t now, oha_htw_expired_fp callback, void * const ctx)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL) {
+        return 0;
+    }
+#endif
+    return oha_htw_advance_int(wheel, now, callback, ctx);
+}
+
+OHA_PUBLIC_API int
+oha_htw_get_status(const struct oha_htw * const wheel, struct oha_lpht_status * const status)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (wheel == NULL || status == NULL) {
+        return -1;
+    }
+#endif
+    return oha_htw_get_status_int(wheel, status);
+}
+
+#endif
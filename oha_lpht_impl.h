@@ -11,38 +11,139 @@
 #include <string.h>
 #include <stdio.h>
 
+#ifdef OHA_WITH_TRACE_SUPPORT
+#include <time.h>
+#endif
+
 #include "oha_utils.h"
 
 #define OHA_LPHT_EMPTY_BUCKET (-1)
 
+// number of keys which are hashed and prefetched in advance by the batch functions
+#define OHA_LPHT_BATCH_SIZE 16
+#define OHA_LPHT_CACHE_LINE_SIZE 64
+
+#ifdef OHA_WITH_TRACE_SUPPORT
+// operation codes of the benchmark file format, see test/README.md
+#define OHA_LPHT_TRACE_INSERT '+'
+#define OHA_LPHT_TRACE_LOOK_UP '?'
+#define OHA_LPHT_TRACE_REMOVE '-'
+
+struct oha_lpht_trace {
+    FILE * file;
+    uint8_t * records;
+    size_t record_size;      // operation + key + time stamp, packed as written to the file
+    uint32_t max_records;
+    uint32_t records_in_use;
+    bool write_failed;       // sticky error of the implicit writes, reported by flush and stop
+};
+#endif
+
+#ifdef OHA_WITH_HASH_TAGS
+// the hash tag are the upper bits of the hash mixed with the lower ones, the additive key hash has almost constant
+// upper bits. The lower bits restore the upper ones, so large tables do not rehash their keys on a resize.
+#define OHA_LPHT_HASH_TAG_SHIFT 24
+#define OHA_LPHT_HASH_TAG_LOW_BITS ((UINT32_C(1) << OHA_LPHT_HASH_TAG_SHIFT) - 1)
+#define OHA_LPHT_HASH_TAG_MIX UINT32_C(0x85EBCA6B)
+// the hash tag takes the upper byte of the probe sequence length
+#define OHA_LPHT_MAX_PSL INT8_MAX
+#else
+#define OHA_LPHT_MAX_PSL INT16_MAX
+#endif
+// every growth adds a value buffer, the rebuild reuses and releases them, create bounds the number of growth steps
+#define OHA_LPHT_MAX_VALUE_BUFFERS (UINT16_MAX + 1)
+
+// split block bloom filter, every key sets one bit in each word of a single block
+#define OHA_LPHT_FILTER_BLOCK_WORDS 8
+#define OHA_LPHT_FILTER_BLOCK_BITS (OHA_LPHT_FILTER_BLOCK_WORDS * 32)
+#define OHA_LPHT_FILTER_MAX_BLOCKS (UINT32_C(1) << 31)
+
 struct oha_lpht_key_bucket {
     uint32_t index;
     uint16_t buffer_id;
+#ifdef OHA_WITH_HASH_TAGS
+    int8_t psl;             // probe sequence length
+    uint8_t hash_tag;
+#else
     int16_t psl;            // probe sequence length
+#endif
     // key buffer is always aligned on 32 bit and 64 bit architectures
     uint8_t key_buffer[];
 };
 
+// entry of the insertion ordered array, the value pointer is stable and identifies the element
+struct oha_lpht_order_entry {
+    void * value; // NULL if the element was removed
+    uint8_t key_buffer[];
+};
+
+// stages of an in-flight look up of the interleaved batch look up
+enum i_oha_lpht_look_up_stage {
+    OHA_LPHT_LOOK_UP_DONE,
+    OHA_LPHT_LOOK_UP_FILTER, // the filter block is prefetched
+    OHA_LPHT_LOOK_UP_PROBE,  // the next bucket to compare is prefetched
+};
+
+struct i_oha_lpht_look_up_state {
+    const struct oha_lpht_key_bucket * bucket;
+    const uint8_t * key;
+    size_t key_index;
+    uint32_t hash;
+    int32_t psl;
+    enum i_oha_lpht_look_up_stage stage;
+};
+
 struct oha_lpht {
     struct oha_lpht_key_bucket * iter; // state of the iterator
     struct oha_memory_fp memory;
     struct oha_memory_pool value_pool;
     struct oha_lpht_key_bucket * key_buckets;
     struct oha_lpht_key_bucket * last_key_bucket;
+    uint64_t * occupied;      // one bit per key bucket, set if the bucket is occupied, NULL if disabled
     size_t key_size;          // origin key size
     size_t key_bucket_size;   // size in bytes of one whole hash table key bucket, memory aligned
+    uint64_t key_bucket_size_inverse; // inverse of the odd part of the key bucket size, for the bucket index
+    uint8_t key_bucket_size_shift;    // number of trailing zero bits of the key bucket size
     size_t value_bucket_size; // size in bytes of one whole hash table value bucket, memory aligned
     uint32_t elems;           // current number of inserted elements
     uint32_t max_elems;       // maxium number of possible elements which can be inserted (obsolet if resizable=true)
     uint32_t max_indicies;    // number of the whole number of the underlaying array also including the left over elements
 
     /*
-     * max_indicies = indicies_pow_of_2_minus_1 + log2_of_indicies
+     * max_indicies = start_indicies_minus_1 + log2_of_indicies
      */
-    uint32_t indicies_pow_of_2_minus_1; // number of elements in the array which will used as fast indexing
+    uint32_t start_indicies_minus_1;    // number of possible start buckets - 1, a mask if fast_range is not set
     float max_load_factor;
     uint8_t log2_of_indicies;           // number of additional elements to avoid array bound checks
     bool resizable;
+    bool fast_range;                    // start buckets are mapped by a multiplication, their number is arbitrary
+    float growth_factor;
+    float shrink_load_factor;           // 0 if the table does not shrink
+    uint32_t min_elems;                 // configured initial size, a shrink does not go below it
+    uint32_t min_indicies;              // number of buckets of the initial size
+    uint16_t grow_probe_length;         // 0 if only the number of elements lets the table grow
+    uint16_t max_probe_length;          // configured bound of the probe sequence length, 0 if unbounded
+    int16_t max_psl;                    // effective bound, also limited by the log n probing and the psl type
+    bool occupied_bitmap;
+    bool block_backward_shift;
+    uint8_t filter_bits_per_elem;       // 0 if the look up filter is disabled
+    uint32_t filter_blocks_mask;        // number of filter blocks - 1
+    uint32_t filter_stale;              // removed elements, which are still marked in the filter
+    uint32_t * filter;                  // blocked bloom filter in front of the key buckets
+
+    /*
+     * insertion ordered mode: a dense array of all elements in insertion order, like a compact dict,
+     * removed elements leave a gap which is closed by the next compaction
+     */
+    uint8_t * order_entries;        // NULL if the table is not insertion ordered
+    size_t order_entry_size;        // size in bytes of one entry, memory aligned
+    size_t order_index_offset;      // position of the entry index behind the value in the value bucket
+    uint32_t order_entries_in_use;  // including the removed entries
+    uint32_t max_order_entries;
+    uint32_t iter_index;            // iterator position, entry index of ordered tables otherwise bucket index
+#ifdef OHA_WITH_TRACE_SUPPORT
+    struct oha_lpht_trace * trace; // NULL if tracing is not active
+#endif
 };
 
 OHA_FORCE_INLINE void
@@ -58,6 +159,7 @@ oha_lpht_iter_next_int(struct oha_lpht * const table, struct oha_key_value_pair
 OHA_PRIVATE_API struct oha_lpht_key_bucket *
 i_oha_lpht_robin_hood_emplace(struct oha_lpht * const table,
                               void const * const key,
+                              uint8_t hash_tag,
                               int16_t psl,
                               struct oha_lpht_key_bucket * iter);
 
@@ -68,10 +170,21 @@ i_oha_lpht_clean_up(struct oha_lpht * const table)
     const struct oha_memory_fp * memory = &table->memory;
 
     oha_free(memory, table->key_buckets);
+    if (table->occupied != NULL) {
+        oha_free(memory, table->occupied);
+    }
     for (size_t i = 0; i < table->value_pool.elems; i++) {
-        oha_free(memory, table->value_pool.buffers[i].data);
+        if (table->value_pool.buffers[i].data != NULL) {
+            oha_free(memory, table->value_pool.buffers[i].data);
+        }
     }
     oha_free(memory, table->value_pool.buffers);
+    if (table->filter != NULL) {
+        oha_free(memory, table->filter);
+    }
+    if (table->order_entries != NULL) {
+        oha_free(memory, table->order_entries);
+    }
 }
 
 OHA_FORCE_INLINE bool
@@ -80,6 +193,74 @@ i_oha_lpht_is_occupied(const struct oha_lpht_key_bucket * const bucket)
     return bucket->psl >= 0;
 }
 
+OHA_FORCE_INLINE size_t
+i_oha_lpht_occupied_size(const uint32_t max_indicies)
+{
+    return ((max_indicies + 63) / 64) * sizeof(uint64_t);
+}
+
+// the byte offset is a multiple of the key bucket size, so the division is replaced by an exact division
+OHA_FORCE_INLINE uint32_t
+i_oha_lpht_get_bucket_index(const struct oha_lpht * const table, const struct oha_lpht_key_bucket * const bucket)
+{
+    const uint64_t offset = (uint64_t)((const uint8_t *)bucket - (const uint8_t *)table->key_buckets);
+    assert(offset % table->key_bucket_size == 0);
+    return (uint32_t)((offset >> table->key_bucket_size_shift) * table->key_bucket_size_inverse);
+}
+
+OHA_FORCE_INLINE struct oha_lpht_key_bucket *
+i_oha_lpht_get_bucket(const struct oha_lpht * const table, const uint32_t index)
+{
+    return (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(table->key_buckets,
+                                                                (size_t)table->key_bucket_size * index);
+}
+
+// the psl of the bucket is the occupied state, the bitmap is only kept in sync for fast scans
+OHA_FORCE_INLINE void
+i_oha_lpht_mark_occupied(const struct oha_lpht * const table, const struct oha_lpht_key_bucket * const bucket)
+{
+    if (table->occupied != NULL) {
+        const uint32_t index = i_oha_lpht_get_bucket_index(table, bucket);
+        table->occupied[index / 64] |= UINT64_C(1) << (index % 64);
+    }
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_mark_empty(const struct oha_lpht * const table, const struct oha_lpht_key_bucket * const bucket)
+{
+    if (table->occupied != NULL) {
+        const uint32_t index = i_oha_lpht_get_bucket_index(table, bucket);
+        table->occupied[index / 64] &= ~(UINT64_C(1) << (index % 64));
+    }
+}
+
+// returns the index of the first occupied bucket at or behind 'index', max_indicies if there is none
+OHA_FORCE_INLINE uint32_t
+i_oha_lpht_next_occupied(const struct oha_lpht * const table, uint32_t index)
+{
+    if (table->occupied == NULL) {
+        while (index < table->max_indicies && !i_oha_lpht_is_occupied(i_oha_lpht_get_bucket(table, index))) {
+            index++;
+        }
+        return OMA_MIN(index, table->max_indicies);
+    }
+
+    // skip 64 empty buckets at once
+    if (index >= table->max_indicies) {
+        return table->max_indicies;
+    }
+    const uint32_t num_words = (table->max_indicies + 63) / 64;
+    uint32_t word_index = index / 64;
+    uint64_t word = table->occupied[word_index] & (UINT64_MAX << (index % 64));
+    while (word == 0) {
+        if (++word_index == num_words) {
+            return table->max_indicies;
+        }
+        word = table->occupied[word_index];
+    }
+    return word_index * 64 + OHA_CTZ64(word);
+}
+
 OHA_FORCE_INLINE void *
 i_oha_lpht_get_value(const struct oha_lpht * const table, const struct oha_lpht_key_bucket * const bucket)
 {
@@ -87,26 +268,268 @@ i_oha_lpht_get_value(const struct oha_lpht * const table, const struct oha_lpht_
                                   table->value_bucket_size * bucket->index);
 }
 
+// the value bucket belongs to the key, so it has to move with the key
+OHA_FORCE_INLINE void
+i_oha_lpht_swap_value_ref(struct oha_lpht_key_bucket * const a, struct oha_lpht_key_bucket * const b)
+{
+    OHA_SWAP(a->index, b->index);
+    OHA_SWAP(a->buffer_id, b->buffer_id);
+}
+
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+// every value bucket stores a copy of its key behind the value
+OHA_FORCE_INLINE void *
+i_oha_lpht_get_key_of_value(const struct oha_lpht * const table, const void * const value)
+{
+    return oha_move_ptr_num_bytes(value, table->value_bucket_size - OHA_ALIGN_UP(table->key_size));
+}
+#endif
+
 OHA_FORCE_INLINE uint32_t
 i_oha_lpht_hash_key(const struct oha_lpht * const table, const void * const key)
 {
     return oha_lpht_hash_32bit(key, table->key_size);
 }
 
+#ifdef OHA_WITH_HASH_TAGS
+OHA_FORCE_INLINE uint8_t
+i_oha_lpht_mix_hash_tag(const uint32_t low_bits)
+{
+    // another multiplier than the one of the fast range, whose upper bits select the start bucket
+    return (uint8_t)((low_bits * OHA_LPHT_HASH_TAG_MIX) >> OHA_LPHT_HASH_TAG_SHIFT);
+}
+#endif
+
+OHA_FORCE_INLINE uint8_t
+i_oha_lpht_hash_tag(const uint32_t hash)
+{
+#ifdef OHA_WITH_HASH_TAGS
+    return (uint8_t)((hash >> OHA_LPHT_HASH_TAG_SHIFT) ^ i_oha_lpht_mix_hash_tag(hash & OHA_LPHT_HASH_TAG_LOW_BITS));
+#else
+    (void)hash;
+    return 0;
+#endif
+}
+
+OHA_FORCE_INLINE uint8_t
+i_oha_lpht_get_hash_tag(const struct oha_lpht_key_bucket * const bucket)
+{
+#ifdef OHA_WITH_HASH_TAGS
+    return bucket->hash_tag;
+#else
+    (void)bucket;
+    return 0;
+#endif
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_set_hash_tag(struct oha_lpht_key_bucket * const bucket, const uint8_t hash_tag)
+{
+#ifdef OHA_WITH_HASH_TAGS
+    bucket->hash_tag = hash_tag;
+#else
+    (void)bucket;
+    (void)hash_tag;
+#endif
+}
+
+// there is always enough space to append, because at least the half of the entries is removed if the array is full
+OHA_FORCE_INLINE uint32_t
+i_oha_lpht_order_calc_entries(const uint32_t max_elems)
+{
+    return max_elems > UINT32_MAX / 2 ? UINT32_MAX : 2 * max_elems;
+}
+
+OHA_FORCE_INLINE struct oha_lpht_order_entry *
+i_oha_lpht_order_get_entry(const struct oha_lpht * const table, const uint32_t entry_index)
+{
+    return (struct oha_lpht_order_entry *)oha_move_ptr_num_bytes(table->order_entries,
+                                                                 table->order_entry_size * entry_index);
+}
+
+OHA_FORCE_INLINE uint32_t *
+i_oha_lpht_order_index_of_value(const struct oha_lpht * const table, void * const value)
+{
+    return (uint32_t *)oha_move_ptr_num_bytes(value, table->order_index_offset);
+}
+
+OHA_PRIVATE_API void
+i_oha_lpht_order_compact(struct oha_lpht * const table)
+{
+    uint32_t in_use = 0;
+    for (uint32_t i = 0; i < table->order_entries_in_use; i++) {
+        struct oha_lpht_order_entry * const entry = i_oha_lpht_order_get_entry(table, i);
+        if (entry->value == NULL) {
+            continue;
+        }
+        if (in_use != i) {
+            memcpy(i_oha_lpht_order_get_entry(table, in_use), entry, table->order_entry_size);
+        }
+        *i_oha_lpht_order_index_of_value(table, entry->value) = in_use;
+        in_use++;
+    }
+    table->order_entries_in_use = in_use;
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_order_append(struct oha_lpht * const table, const void * const key, void * const value)
+{
+    if (table->order_entries_in_use == table->max_order_entries) {
+        i_oha_lpht_order_compact(table);
+    }
+    assert(table->order_entries_in_use < table->max_order_entries);
+
+    const uint32_t entry_index = table->order_entries_in_use++;
+    struct oha_lpht_order_entry * const entry = i_oha_lpht_order_get_entry(table, entry_index);
+    entry->value = value;
+    memcpy(entry->key_buffer, key, table->key_size);
+    *i_oha_lpht_order_index_of_value(table, value) = entry_index;
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_order_remove(struct oha_lpht * const table, void * const value)
+{
+    const uint32_t entry_index = *i_oha_lpht_order_index_of_value(table, value);
+    assert(entry_index < table->order_entries_in_use);
+    assert(i_oha_lpht_order_get_entry(table, entry_index)->value == value);
+    i_oha_lpht_order_get_entry(table, entry_index)->value = NULL;
+    if (entry_index + 1 == table->order_entries_in_use) {
+        // the youngest element needs no gap
+        table->order_entries_in_use--;
+    }
+}
+
+OHA_FORCE_INLINE uint32_t
+i_oha_lpht_filter_calc_blocks(const uint32_t max_elems, const uint8_t bits_per_elem)
+{
+    const uint64_t bits = (uint64_t)max_elems * bits_per_elem;
+    const uint64_t blocks = (bits + OHA_LPHT_FILTER_BLOCK_BITS - 1) / OHA_LPHT_FILTER_BLOCK_BITS;
+    if (blocks >= OHA_LPHT_FILTER_MAX_BLOCKS) {
+        return OHA_LPHT_FILTER_MAX_BLOCKS;
+    }
+    return oha_next_power_of_two_32bit(OHA_MAX((uint32_t)blocks, 1));
+}
+
+OHA_FORCE_INLINE size_t
+i_oha_lpht_filter_size(const struct oha_lpht * const table)
+{
+    return ((size_t)table->filter_blocks_mask + 1) * OHA_LPHT_FILTER_BLOCK_WORDS * sizeof(uint32_t);
+}
+
+OHA_FORCE_INLINE uint32_t *
+i_oha_lpht_filter_get_block(uint32_t * const filter, const uint32_t blocks_mask, const uint32_t hash)
+{
+    // the start bucket is taken from the lower hash bits, so take the block from the mixed upper bits
+    const uint32_t block = (uint32_t)(((uint64_t)hash * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & blocks_mask;
+    return filter + (size_t)block * OHA_LPHT_FILTER_BLOCK_WORDS;
+}
+
+OHA_FORCE_INLINE uint32_t
+i_oha_lpht_filter_bit(const uint32_t hash, const size_t word)
+{
+    static const uint32_t salts[OHA_LPHT_FILTER_BLOCK_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return UINT32_C(1) << ((hash * salts[word]) >> 27);
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_filter_add(uint32_t * const filter, const uint32_t blocks_mask, const uint32_t hash)
+{
+    uint32_t * const block = i_oha_lpht_filter_get_block(filter, blocks_mask, hash);
+    for (size_t i = 0; i < OHA_LPHT_FILTER_BLOCK_WORDS; i++) {
+        block[i] |= i_oha_lpht_filter_bit(hash, i);
+    }
+}
+
+// returns false if the key is definitely not in the table, always true if the filter is disabled
+OHA_FORCE_INLINE bool
+i_oha_lpht_filter_may_contain(const struct oha_lpht * const table, const uint32_t hash)
+{
+    if (table->filter == NULL) {
+        return true;
+    }
+    const uint32_t * const block = i_oha_lpht_filter_get_block(table->filter, table->filter_blocks_mask, hash);
+    for (size_t i = 0; i < OHA_LPHT_FILTER_BLOCK_WORDS; i++) {
+        if ((block[i] & i_oha_lpht_filter_bit(hash, i)) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * The *_sized helpers take the key size as argument, so a caller with a compile time key size, like the C++
+ * wrapper, gets the key compare and the hash unrolled for its key type.
+ */
+OHA_FORCE_INLINE bool
+i_oha_lpht_is_key_equal_sized(const struct oha_lpht_key_bucket * const bucket,
+                              const void * const key,
+                              const uint8_t hash_tag,
+                              const size_t key_size)
+{
+#ifdef OHA_WITH_HASH_TAGS
+    // reject most of the other keys without touching the key buffer
+    if (bucket->hash_tag != hash_tag) {
+        return false;
+    }
+#else
+    (void)hash_tag;
+#endif
+    return memcmp(bucket->key_buffer, key, key_size) == 0;
+}
+
+OHA_FORCE_INLINE bool
+i_oha_lpht_is_key_equal(const struct oha_lpht * const table,
+                        const struct oha_lpht_key_bucket * const bucket,
+                        const void * const key,
+                        const uint8_t hash_tag)
+{
+    return i_oha_lpht_is_key_equal_sized(bucket, key, hash_tag, table->key_size);
+}
+
 OHA_FORCE_INLINE struct oha_lpht_key_bucket *
 i_oha_lpht_get_start_bucket(const struct oha_lpht * const table, uint32_t hash)
 {
-    size_t index = hash & table->indicies_pow_of_2_minus_1;
-    return oha_move_ptr_num_bytes(table->key_buckets, table->key_bucket_size * index);
+    size_t index;
+    if (table->fast_range) {
+        // mix the lower hash bits into the upper ones, which select the start bucket
+        index = oha_map_range_u32(hash * UINT32_C(0x9E3779B1), table->start_indicies_minus_1 + 1);
+    } else {
+        index = hash & table->start_indicies_minus_1;
+    }
+    return (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(table->key_buckets, table->key_bucket_size * index);
+}
+
+/*
+ * Hash of an element for a rebuild. With hash tags, the start bucket of a table with at least 2^24 start buckets
+ * selected by a mask holds the lower hash bits and the hash tag restores the upper ones, so the key is not hashed.
+ */
+OHA_FORCE_INLINE uint32_t
+i_oha_lpht_rebuild_hash(const struct oha_lpht * const table,
+                        const uint32_t bucket_index,
+                        const struct oha_lpht_key_bucket * const bucket)
+{
+#ifdef OHA_WITH_HASH_TAGS
+    if (!table->fast_range && table->start_indicies_minus_1 >= OHA_LPHT_HASH_TAG_LOW_BITS) {
+        // the mask keeps the lower bits also for a probe sequence which wraps around the end
+        const uint32_t low_bits = (bucket_index - (uint32_t)bucket->psl) & OHA_LPHT_HASH_TAG_LOW_BITS;
+        const uint8_t high_bits = (uint8_t)(bucket->hash_tag ^ i_oha_lpht_mix_hash_tag(low_bits));
+        return ((uint32_t)high_bits << OHA_LPHT_HASH_TAG_SHIFT) | low_bits;
+    }
+#else
+    (void)bucket_index;
+#endif
+    return i_oha_lpht_hash_key(table, bucket->key_buffer);
 }
 
 OHA_FORCE_INLINE struct oha_lpht_key_bucket *
 i_oha_lpht_get_next_bucket(const struct oha_lpht * const table, const struct oha_lpht_key_bucket * const bucket)
 {
 #if OHA_MAX_LOG_N_PROBING
-    return oha_move_ptr_num_bytes(bucket, table->key_bucket_size);
+    return (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(bucket, table->key_bucket_size);
 #else
-    struct oha_lpht_key_bucket * current = oha_move_ptr_num_bytes(bucket, table->key_bucket_size);
+    struct oha_lpht_key_bucket * current =
+        (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(bucket, table->key_bucket_size);
     // overflow, get to the first elem
     if (current > table->last_key_bucket) {
         current = table->key_buckets;
@@ -115,6 +538,25 @@ i_oha_lpht_get_next_bucket(const struct oha_lpht * const table, const struct oha
 #endif
 }
 
+// the log n probing does not wrap around, an always empty bucket behind the last one ends all probe loops
+#if OHA_MAX_LOG_N_PROBING
+#define OHA_LPHT_SENTINEL_BUCKETS 1
+#else
+#define OHA_LPHT_SENTINEL_BUCKETS 0
+#endif
+
+OHA_FORCE_INLINE void
+i_oha_lpht_init_sentinel(const struct oha_lpht * const table)
+{
+#if OHA_MAX_LOG_N_PROBING
+    struct oha_lpht_key_bucket * const sentinel =
+        (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(table->last_key_bucket, table->key_bucket_size);
+    sentinel->psl = OHA_LPHT_EMPTY_BUCKET;
+#else
+    (void)table;
+#endif
+}
+
 OHA_FORCE_INLINE void
 i_oha_lpht_calc_storage(struct oha_lpht * const table, uint32_t max_elems)
 {
@@ -126,13 +568,22 @@ i_oha_lpht_calc_storage(struct oha_lpht * const table, uint32_t max_elems)
     const uint32_t needed_elems = OHA_MAX(ceil((1.0F / table->max_load_factor) * (float)max_elems), 2);
     const uint32_t next_pow_of_2 = oha_next_power_of_two_32bit(needed_elems);
     assert(needed_elems <= next_pow_of_2);
+    const uint32_t start_indicies = table->fast_range ? needed_elems : next_pow_of_2;
 #if OHA_MAX_LOG_N_PROBING
     table->log2_of_indicies = OHA_MAX(oha_log2_32bit(next_pow_of_2), 4);
 #else
-    table->log2_of_indicies = 1; // we perform the bound check, now: max_indicies = indicies_pow_of_2_minus_1 + 1
+    table->log2_of_indicies = 1; // we perform the bound check, now: max_indicies = start_indicies_minus_1 + 1
+#endif
+    table->start_indicies_minus_1 = start_indicies - 1;
+    table->max_indicies = table->start_indicies_minus_1 + table->log2_of_indicies;
+#if OHA_MAX_LOG_N_PROBING
+    table->max_psl = table->log2_of_indicies - 1; // the last start bucket reaches the last bucket
+#else
+    table->max_psl = OHA_LPHT_MAX_PSL;
 #endif
-    table->indicies_pow_of_2_minus_1 = next_pow_of_2 - 1;
-    table->max_indicies = table->indicies_pow_of_2_minus_1 + table->log2_of_indicies;
+    if (table->max_probe_length > 0) {
+        table->max_psl = OMA_MIN(table->max_psl, (int16_t)table->max_probe_length);
+    }
     if (table->resizable) {
         table->max_elems = table->max_indicies * table->max_load_factor;
     } else {
@@ -147,16 +598,26 @@ i_oha_lpht_init_table(struct oha_lpht * const table)
      * 1. allocate needed memory
      */
     const struct oha_memory_fp * memory = &table->memory;
-    table->key_buckets = oha_malloc(memory, table->key_bucket_size * (table->max_indicies));
+    table->key_buckets =
+        (struct oha_lpht_key_bucket *)oha_malloc(
+        memory, table->key_bucket_size * (table->max_indicies + OHA_LPHT_SENTINEL_BUCKETS));
     if (table->key_buckets == NULL) {
         i_oha_lpht_clean_up(table);
         return -1;
     }
-    table->last_key_bucket =
-        oha_move_ptr_num_bytes(table->key_buckets, table->key_bucket_size * (table->max_indicies - 1));
+    table->last_key_bucket = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(
+        table->key_buckets, table->key_bucket_size * (table->max_indicies - 1));
     table->iter = NULL;
 
-    table->value_pool.buffers = oha_malloc(memory, sizeof(table->value_pool));
+    if (table->occupied_bitmap) {
+        table->occupied = (uint64_t *)oha_calloc(memory, i_oha_lpht_occupied_size(table->max_indicies));
+        if (table->occupied == NULL) {
+            i_oha_lpht_clean_up(table);
+            return -6;
+        }
+    }
+
+    table->value_pool.buffers = (struct oha_buffer *)oha_malloc(memory, sizeof(table->value_pool));
     if (table->value_pool.buffers == NULL) {
         i_oha_lpht_clean_up(table);
         return -2;
@@ -164,14 +625,33 @@ i_oha_lpht_init_table(struct oha_lpht * const table)
     table->value_pool.elems = 1;
 
 #ifdef OHA_CALLOC_LPHT_VALUE_AT_INIT
-    table->value_pool.buffers[0].data = oha_calloc(memory, table->value_bucket_size * (table->max_indicies));
+    table->value_pool.buffers[0].data = (uint8_t *)oha_calloc(memory, table->value_bucket_size * (table->max_indicies));
 #else
-    table->value_pool.buffers[0].data = oha_malloc(memory, table->value_bucket_size * (table->max_indicies));
+    table->value_pool.buffers[0].data = (uint8_t *)oha_malloc(memory, table->value_bucket_size * (table->max_indicies));
 #endif
     if (table->value_pool.buffers[0].data == NULL) {
         i_oha_lpht_clean_up(table);
         return -3;
     }
+    table->value_pool.buffers[0].max_elems = table->max_indicies;
+
+    if (table->filter_bits_per_elem > 0) {
+        table->filter_blocks_mask = i_oha_lpht_filter_calc_blocks(table->max_elems, table->filter_bits_per_elem) - 1;
+        table->filter = (uint32_t *)oha_calloc(memory, i_oha_lpht_filter_size(table));
+        if (table->filter == NULL) {
+            i_oha_lpht_clean_up(table);
+            return -4;
+        }
+    }
+
+    if (table->order_entry_size > 0) {
+        table->max_order_entries = i_oha_lpht_order_calc_entries(table->max_elems);
+        table->order_entries = (uint8_t *)oha_malloc(memory, table->order_entry_size * table->max_order_entries);
+        if (table->order_entries == NULL) {
+            i_oha_lpht_clean_up(table);
+            return -5;
+        }
+    }
 
     /*
      * 2. connect key buckets and value buckets of both arrays
@@ -181,194 +661,539 @@ i_oha_lpht_init_table(struct oha_lpht * const table)
         iter_key->index = i;
         iter_key->buffer_id = 0;
         iter_key->psl = OHA_LPHT_EMPTY_BUCKET;
-        iter_key = oha_move_ptr_num_bytes(iter_key, table->key_bucket_size);
+        iter_key = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(iter_key, table->key_bucket_size);
     }
+    i_oha_lpht_init_sentinel(table);
 
     return 0;
 }
 
+// releases the buffers of a not completed resize
+OHA_FORCE_INLINE void
+i_oha_lpht_free_resize_buffers(const struct oha_memory_fp * const memory, const struct oha_lpht * const new_table)
+{
+    oha_free(memory, new_table->key_buckets);
+    if (new_table->occupied != NULL) {
+        oha_free(memory, new_table->occupied);
+    }
+    if (new_table->filter != NULL) {
+        oha_free(memory, new_table->filter);
+    }
+}
+
+// returns the number of value buckets of all value buffers
+OHA_FORCE_INLINE uint64_t
+i_oha_lpht_value_buckets(const struct oha_lpht * const table)
+{
+    uint64_t value_buckets = 0;
+    for (uint32_t i = 0; i < table->value_pool.elems; i++) {
+        value_buckets += table->value_pool.buffers[i].max_elems;
+    }
+    return value_buckets;
+}
+
+/*
+ * Connects the empty key buckets of a rebuild table with the value buckets without an element, the elements keep
+ * their value buckets. The value buckets are taken from the buffers which hold elements anyway, then from whole free
+ * buffers which fit into the remaining need and at last from a new buffer. All other buffers are released, also the
+ * free value buckets left over by a shrink are found again by the next rebuild. On error nothing is changed.
+ */
 OHA_PRIVATE_API int
-i_oha_lpht_resize(struct oha_lpht * const table, const uint32_t max_elems)
+i_oha_lpht_connect_free_values(struct oha_lpht * const table, const int32_t pinned_buffer_id)
 {
-    if (!table->resizable) {
-        return -1;
+    const struct oha_memory_fp * memory = &table->memory;
+    struct oha_memory_pool * const pool = &table->value_pool;
+    const uint32_t num_buffers = pool->elems;
+
+    // 1. mark the value buckets of all elements, the value buckets of all buffers are numbered one after another
+    // too large for the stack with the maximum number of buffers
+    uint64_t * const offsets = (uint64_t *)oha_malloc(memory, (num_buffers + 1) * (sizeof(uint64_t) + sizeof(bool)));
+    if (offsets == NULL) {
+        return -10;
+    }
+    bool * const keep = (bool *)&offsets[num_buffers + 1];
+    offsets[0] = 0;
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        offsets[i + 1] = offsets[i] + pool->buffers[i].max_elems;
+        keep[i] = (int32_t)i == pinned_buffer_id;
+    }
+    uint64_t * const used = (uint64_t *)oha_calloc(memory, ((offsets[num_buffers] + 63) / 64) * sizeof(uint64_t));
+    if (used == NULL) {
+        oha_free(memory, offsets);
+        return -10;
+    }
+    for (const struct oha_lpht_key_bucket * iter = table->key_buckets; iter <= table->last_key_bucket;
+         iter = (const struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(iter, table->key_bucket_size)) {
+        if (i_oha_lpht_is_occupied(iter)) {
+            const uint64_t number = offsets[iter->buffer_id] + iter->index;
+            used[number / 64] |= UINT64_C(1) << (number % 64);
+            keep[iter->buffer_id] = true;
+        }
     }
 
-    if (max_elems <= table->max_elems) {
-        // nothing todo
-        return 0;
+    // 2. choose the buffers to keep and the size of a new one
+    uint64_t free_value_buckets = 0;
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        if (keep[i]) {
+            free_value_buckets += pool->buffers[i].max_elems;
+        }
+    }
+    free_value_buckets -= table->elems;
+    const uint32_t needed = table->max_indicies - table->elems;
+    uint64_t missing = needed > free_value_buckets ? needed - free_value_buckets : 0;
+    for (uint32_t i = 0; i < num_buffers && missing > 0; i++) {
+        if (!keep[i] && pool->buffers[i].data != NULL && pool->buffers[i].max_elems <= missing) {
+            keep[i] = true;
+            missing -= pool->buffers[i].max_elems;
+        }
+    }
+
+    // 3. allocate the new buffer, the id of a released buffer is reused
+    uint32_t new_buffer_id = num_buffers;
+    uint8_t * new_data = NULL;
+    if (missing > 0) {
+        for (uint32_t i = 0; i < num_buffers; i++) {
+            if (!keep[i]) {
+                new_buffer_id = i;
+                break;
+            }
+        }
+#ifdef OHA_CALLOC_LPHT_VALUE_AT_INIT
+        new_data = (uint8_t *)oha_calloc(memory, table->value_bucket_size * missing);
+#else
+        new_data = (uint8_t *)oha_malloc(memory, table->value_bucket_size * missing);
+#endif
+        if (new_data == NULL) {
+            oha_free(memory, used);
+            oha_free(memory, offsets);
+            return -3;
+        }
+        if (new_buffer_id == num_buffers) {
+            size_t elems = num_buffers;
+            if (new_buffer_id >= OHA_LPHT_MAX_VALUE_BUFFERS) {
+                oha_free(memory, new_data);
+                oha_free(memory, used);
+                oha_free(memory, offsets);
+                return -5;
+            }
+            if (!oha_add_entry_to_array(memory, (void **)&pool->buffers, sizeof(*pool->buffers), &elems)) {
+                oha_free(memory, new_data);
+                oha_free(memory, used);
+                oha_free(memory, offsets);
+                return -4;
+            }
+            assert(elems == (size_t)num_buffers + 1);
+            pool->elems = elems;
+            pool->buffers[new_buffer_id].data = NULL;
+        }
+    }
+
+    // 4. nothing fails anymore, release the not kept buffers
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        if (!keep[i] && pool->buffers[i].data != NULL) {
+            oha_free(memory, pool->buffers[i].data);
+            pool->buffers[i].data = NULL;
+            pool->buffers[i].max_elems = 0;
+        }
     }
+    if (new_data != NULL) {
+        pool->buffers[new_buffer_id].data = new_data;
+        pool->buffers[new_buffer_id].max_elems = (uint32_t)missing;
+    }
+
+    // 5. connect the empty key buckets, first with the free value buckets of the kept buffers
+    uint32_t buffer_id = 0;
+    uint32_t index = 0;
+    uint32_t new_index = 0;
+    for (struct oha_lpht_key_bucket * iter = table->key_buckets; iter <= table->last_key_bucket;
+         iter = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(iter, table->key_bucket_size)) {
+        if (i_oha_lpht_is_occupied(iter)) {
+            continue;
+        }
+        while (buffer_id < num_buffers) {
+            const uint64_t number = offsets[buffer_id] + index;
+            if (!keep[buffer_id] || number >= offsets[buffer_id + 1]) {
+                buffer_id++;
+                index = 0;
+            } else if ((used[number / 64] >> (number % 64)) & 1) {
+                index++;
+            } else {
+                break;
+            }
+        }
+        if (buffer_id < num_buffers) {
+            iter->index = index++;
+            iter->buffer_id = (uint16_t)buffer_id;
+        } else {
+            iter->index = new_index++;
+            iter->buffer_id = (uint16_t)new_buffer_id;
+        }
+    }
+    assert(new_index == missing);
+    oha_free(memory, used);
+    oha_free(memory, offsets);
+    return 0;
+}
+
+/*
+ * Moves all elements into a new key bucket array of another size, the value buckets are not moved. An empty table is
+ * also rebuild with the same size to release the value buffers of its former size. 'pinned_buffer_id' is the value
+ * buffer of a just removed element, which is not released, or -1.
+ */
+OHA_PRIVATE_API int
+i_oha_lpht_rebuild(struct oha_lpht * const table, const uint32_t max_elems, const int32_t pinned_buffer_id)
+{
+    assert(table->resizable);
+    assert(table->elems <= max_elems);
 
     struct oha_lpht new_table = *table;
     i_oha_lpht_calc_storage(&new_table, max_elems);
-    if (table->max_indicies == new_table.max_indicies) {
+    if (table->max_indicies == new_table.max_indicies && table->elems > 0) {
         return 0;
     }
 
-    assert(table->max_indicies < new_table.max_indicies);
-    assert(table->max_elems < new_table.max_elems);
-    assert(table->max_indicies < new_table.max_indicies);
-
     /*
      * allocate needed memory
      */
     const struct oha_memory_fp * memory = &table->memory;
-    new_table.key_buckets = oha_malloc(memory, new_table.key_bucket_size * new_table.max_indicies);
+    new_table.key_buckets =
+        (struct oha_lpht_key_bucket *)oha_malloc(
+        memory, new_table.key_bucket_size * (new_table.max_indicies + OHA_LPHT_SENTINEL_BUCKETS));
     if (new_table.key_buckets == NULL) {
         return -2;
     }
-    new_table.last_key_bucket =
-        oha_move_ptr_num_bytes(new_table.key_buckets, new_table.key_bucket_size * (new_table.max_indicies - 1));
+    new_table.last_key_bucket = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(
+        new_table.key_buckets, new_table.key_bucket_size * (new_table.max_indicies - 1));
     new_table.iter = NULL;
+    new_table.filter = NULL;
+
+    new_table.occupied = NULL;
+    if (table->occupied != NULL) {
+        new_table.occupied = (uint64_t *)oha_calloc(memory, i_oha_lpht_occupied_size(new_table.max_indicies));
+        if (new_table.occupied == NULL) {
+            i_oha_lpht_free_resize_buffers(memory, &new_table);
+            return -8;
+        }
+    }
 
-    // TODO reduce memory overhead of allocation
-    const uint32_t new_needed_elems = new_table.max_indicies - table->elems;
-    void * new_data =
-#ifdef OHA_CALLOC_LPHT_VALUE_AT_INIT
-        oha_calloc(memory, new_table.value_bucket_size * new_needed_elems);
-#else
-        oha_malloc(memory, new_table.value_bucket_size * new_needed_elems);
-#endif
-    if (new_data == NULL) {
-        oha_free(memory, new_table.key_buckets);
-        return -3;
+    // the filter is rebuild with the new size, all removed elements disappear
+    if (table->filter != NULL) {
+        new_table.filter_blocks_mask =
+            i_oha_lpht_filter_calc_blocks(new_table.max_elems, new_table.filter_bits_per_elem) - 1;
+        new_table.filter = (uint32_t *)oha_calloc(memory, i_oha_lpht_filter_size(&new_table));
+        if (new_table.filter == NULL) {
+            i_oha_lpht_free_resize_buffers(memory, &new_table);
+            return -6;
+        }
+        new_table.filter_stale = 0;
     }
 
-    size_t num_buffers = new_table.value_pool.elems;
-    const size_t new_buffer_id = num_buffers;
-    if (!oha_add_entry_to_array(
-            memory, (void *)&new_table.value_pool.buffers, sizeof(*new_table.value_pool.buffers), &num_buffers)) {
-        oha_free(memory, new_table.key_buckets);
-        oha_free(memory, new_data);
-        return -4;
+    // the ordered entries and the value buckets do not move, only the free space of the array grows
+    const uint32_t max_order_entries = i_oha_lpht_order_calc_entries(max_elems);
+    if (table->order_entries != NULL && max_order_entries > table->max_order_entries) {
+        uint8_t * const order_entries = (uint8_t *)oha_realloc(
+            memory, table->order_entries, table->order_entry_size * max_order_entries);
+        if (order_entries == NULL) {
+            i_oha_lpht_free_resize_buffers(memory, &new_table);
+            return -7;
+        }
+        // the old array is already released, also if one of the next steps fails
+        table->order_entries = order_entries;
+        new_table.order_entries = order_entries;
+        new_table.max_order_entries = max_order_entries;
     }
-    assert(num_buffers == ((size_t)new_table.value_pool.elems) + 1);
 
     // update table
-    new_table.value_pool.buffers[new_table.value_pool.elems].data = new_data;
-    new_table.value_pool.elems = num_buffers;
     new_table.max_elems = max_elems;
     new_table.elems = 0;
 
     // mark new table key buckets as empty
     for (struct oha_lpht_key_bucket * iter = new_table.key_buckets; iter <= new_table.last_key_bucket;
-         iter = oha_move_ptr_num_bytes(iter, new_table.key_bucket_size)) {
+         iter = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(iter, new_table.key_bucket_size)) {
         iter->psl = OHA_LPHT_EMPTY_BUCKET;
     }
-
-    // rehash and emplace all old keys
-    uint32_t new_free_value_id = table->elems;
-    for (struct oha_lpht_key_bucket * iter = table->key_buckets; iter <= table->last_key_bucket;
-         iter = oha_move_ptr_num_bytes(iter, table->key_bucket_size)) {
-        if (!i_oha_lpht_is_occupied(iter)) {
-            iter->index = new_free_value_id;
-            iter->buffer_id = new_buffer_id;
-            new_free_value_id++;
-            continue;
+    i_oha_lpht_init_sentinel(&new_table);
+
+    // emplace all old keys
+    for (uint32_t bucket_index = i_oha_lpht_next_occupied(table, 0); bucket_index < table->max_indicies;
+         bucket_index = i_oha_lpht_next_occupied(table, bucket_index + 1)) {
+        const struct oha_lpht_key_bucket * const iter = i_oha_lpht_get_bucket(table, bucket_index);
+        assert(i_oha_lpht_is_occupied(iter));
+        const uint32_t hash = i_oha_lpht_rebuild_hash(table, bucket_index, iter);
+        assert(hash == i_oha_lpht_hash_key(table, iter->key_buffer));
+        if (new_table.filter != NULL) {
+            i_oha_lpht_filter_add(new_table.filter, new_table.filter_blocks_mask, hash);
         }
-        assert(iter->index < table->max_indicies);
-        uint32_t hash = i_oha_lpht_hash_key(&new_table, iter->key_buffer);
         struct oha_lpht_key_bucket * new_bucket = i_oha_lpht_get_start_bucket(&new_table, hash);
-        struct oha_lpht_key_bucket * new_place =
-            i_oha_lpht_robin_hood_emplace(&new_table, iter->key_buffer, 0, new_bucket);
 
-        assert(new_place);
+        // keys are unique, so only skip the richer buckets to find the robin hood position
+        int16_t psl = 0;
+        for (; psl <= new_table.max_psl && psl <= new_bucket->psl;
+             new_bucket = i_oha_lpht_get_next_bucket(&new_table, new_bucket), ++psl) {
+        }
+        struct oha_lpht_key_bucket * new_place =
+            psl <= new_table.max_psl
+                ? i_oha_lpht_robin_hood_emplace(&new_table, iter->key_buffer, i_oha_lpht_get_hash_tag(iter), psl, new_bucket)
+                : NULL;
+        if (new_place == NULL) {
+            // a probe sequence exceeds the bound, nothing of the old table is changed yet
+            i_oha_lpht_free_resize_buffers(memory, &new_table);
+            return -9;
+        }
         assert(oha_lpht_look_up_int(&new_table, iter->key_buffer) == new_place);
         new_place->index = iter->index;
         new_place->buffer_id = iter->buffer_id;
     }
     assert(table->elems == new_table.elems); // copied all inserted elemets to new structure
 
-    uint32_t tmp_bucket_number = table->elems;
-    for (struct oha_lpht_key_bucket * iter = new_table.key_buckets; iter <= new_table.last_key_bucket;
-         iter = oha_move_ptr_num_bytes(iter, new_table.key_bucket_size)) {
-        if (iter->psl == OHA_LPHT_EMPTY_BUCKET) {
-            iter->index = tmp_bucket_number;
-            iter->buffer_id = new_buffer_id;
-            tmp_bucket_number++;
-        }
+    const int connected = i_oha_lpht_connect_free_values(&new_table, pinned_buffer_id);
+    if (connected != 0) {
+        i_oha_lpht_free_resize_buffers(memory, &new_table);
+        return connected;
     }
-    assert(tmp_bucket_number == new_table.max_indicies);
 
     oha_free(memory, table->key_buckets);
+    if (table->occupied != NULL) {
+        oha_free(memory, table->occupied);
+    }
+    if (table->filter != NULL) {
+        oha_free(memory, table->filter);
+    }
     *table = new_table;
 
     return 0;
 }
 
+/*
+ * Grows the table to at least max_elems. Every growth takes at least one growth_factor step, because each one adds a
+ * value buffer and the number of buffers is limited. So also reserves and batches in small steps reach 2^32 elements.
+ */
+OHA_PRIVATE_API int
+i_oha_lpht_resize(struct oha_lpht * const table, const uint32_t max_elems)
+{
+    if (!table->resizable) {
+        return -1;
+    }
+
+    if (max_elems <= table->max_elems) {
+        // nothing todo
+        return 0;
+    }
+    const uint64_t step = (uint64_t)((double)table->max_elems * table->growth_factor);
+    return i_oha_lpht_rebuild(table, (uint32_t)OMA_MIN(OHA_MAX(step, (uint64_t)max_elems), UINT32_MAX), -1);
+}
+
 OHA_FORCE_INLINE int
 i_oha_lpht_grow(struct oha_lpht * const table)
 {
-    return i_oha_lpht_resize(table, 2 * table->max_elems);
+    if (table->max_elems == UINT32_MAX) {
+        return -1;
+    }
+    return i_oha_lpht_resize(table, table->max_elems + 1);
+}
+
+/*
+ * Shrinks resizable tables with a shrink load factor, if they became too sparse. The value buffer of a just removed
+ * element is pinned, so its value stays readable until the next call which modifies the table.
+ */
+OHA_FORCE_INLINE void
+i_oha_lpht_shrink_if_sparse(struct oha_lpht * const table, const int32_t pinned_buffer_id)
+{
+    if (!table->resizable || table->shrink_load_factor <= 0) {
+        return;
+    }
+    if (table->elems == 0) {
+        // a drained table shrinks to the initial size and keeps only the value buckets of this size
+        if (table->max_indicies > table->min_indicies || i_oha_lpht_value_buckets(table) > table->max_indicies) {
+            (void)i_oha_lpht_rebuild(table, table->min_elems, pinned_buffer_id);
+        }
+        return;
+    }
+    if (table->max_indicies <= table->min_indicies ||
+        (float)table->elems >= table->shrink_load_factor * (float)table->max_indicies) {
+        return;
+    }
+    // afterwards the table is filled as one growth step below the maximum, a failed shrink keeps the table
+    const uint32_t max_elems = (uint32_t)((double)table->elems * table->growth_factor);
+    (void)i_oha_lpht_rebuild(table, OHA_MAX(max_elems, table->min_elems), pinned_buffer_id);
 }
 
+// moves the run of 'num_buckets' buckets starting at 'first' one bucket forward, the run may wrap around the end
+OHA_FORCE_INLINE void
+i_oha_lpht_shift_forward(struct oha_lpht * const table, struct oha_lpht_key_bucket * const first, size_t num_buckets)
+{
+    const size_t buckets_to_end =
+        (size_t)((uint8_t *)table->last_key_bucket - (uint8_t *)first) / table->key_bucket_size;
+    if (num_buckets > buckets_to_end) {
+        // move the wrapped part first, to free the first bucket for the last one
+        const size_t second_part = num_buckets - buckets_to_end - 1;
+        memmove(oha_move_ptr_num_bytes(table->key_buckets, table->key_bucket_size),
+                table->key_buckets,
+                second_part * table->key_bucket_size);
+        memcpy(table->key_buckets, table->last_key_bucket, table->key_bucket_size);
+        num_buckets = buckets_to_end;
+    }
+    memmove(oha_move_ptr_num_bytes(first, table->key_bucket_size), first, num_buckets * table->key_bucket_size);
+}
+
+// returns the bucket of the new key or NULL if a shifted bucket would exceed the probe sequence length bound
 OHA_PRIVATE_API struct oha_lpht_key_bucket *
 i_oha_lpht_robin_hood_emplace(struct oha_lpht * const table,
                               void const * const key,
+                              uint8_t hash_tag,
                               int16_t psl,
                               struct oha_lpht_key_bucket * iter)
 {
-    if (table->elems >= table->max_elems) {
-        // double size table
-        if (i_oha_lpht_grow(table)) {
+    assert(table->elems < table->max_elems);
+
+    // 1. find the first empty bucket, all buckets in front of it are shifted and get poorer by one
+    size_t num_buckets = 0;
+    struct oha_lpht_key_bucket * empty = iter;
+    for (; i_oha_lpht_is_occupied(empty); empty = i_oha_lpht_get_next_bucket(table, empty), num_buckets++) {
+        bool too_long = empty->psl >= table->max_psl;
+#if OHA_MAX_LOG_N_PROBING
+        // the log n probing does not wrap around
+        too_long = too_long || empty == table->last_key_bucket;
+#endif
+        if (too_long) {
+            // undo and let the caller grow the table or reject the key
+            for (; iter != empty; iter = i_oha_lpht_get_next_bucket(table, iter)) {
+                iter->psl--;
+            }
             return NULL;
         }
-        return oha_lpht_insert_int(table, key);
-    } else if (!i_oha_lpht_is_occupied(iter)) {
-        // terminate robin hood insertion, we found a empty bucket
-        memcpy(iter->key_buffer, key, table->key_size);
-        iter->psl = psl;
-        table->elems++;
-        return iter;
+        empty->psl++;
     }
 
-    // 1. copy poor bucket to temporal memory buffer
-    char buffer[table->key_bucket_size];
-    struct oha_lpht_key_bucket * tmp_key_bucket = (struct oha_lpht_key_bucket *)buffer;
-    memcpy(tmp_key_bucket->key_buffer, key, table->key_size);
-    tmp_key_bucket->index = iter->index;
+    // 2. shift the run with a single memmove, the value bucket of the empty bucket is taken by the new key
+    const uint32_t free_index = empty->index;
+    const uint8_t free_buffer_id = empty->buffer_id;
+    if (num_buckets > 0) {
+        i_oha_lpht_shift_forward(table, iter, num_buckets);
+    }
 
-    // swap poor and the rich bucket
-    struct oha_lpht_key_bucket * const inserted_key_bucket = iter;
-    i_oha_swap_memory(iter->key_buffer, tmp_key_bucket->key_buffer, table->key_size);
-    OHA_SWAP(iter->psl, psl);
+    memcpy(iter->key_buffer, key, table->key_size);
+    i_oha_lpht_set_hash_tag(iter, hash_tag);
+    iter->psl = psl;
+    iter->index = free_index;
+    iter->buffer_id = free_buffer_id;
+    i_oha_lpht_mark_occupied(table, empty);
+    table->elems++;
+    return iter;
+}
 
-    for (++psl, iter = i_oha_lpht_get_next_bucket(table, iter);;
-         ++psl, iter = i_oha_lpht_get_next_bucket(table, iter)) {
-        if (!i_oha_lpht_is_occupied(iter)) {
-            // terminate robin hood insertion, we found a empty bucket
-            iter->psl = psl;
-            memcpy(iter->key_buffer, tmp_key_bucket->key_buffer, table->key_size);
-            OHA_SWAP(tmp_key_bucket->index, iter->index);
-            table->elems++;
-            inserted_key_bucket->index = tmp_key_bucket->index;
-            return inserted_key_bucket;
-        } else if (psl > iter->psl) {
-            // apply robin hood creed and swap the poor and the rich bucket
-            i_oha_swap_memory(iter->key_buffer, tmp_key_bucket->key_buffer, table->key_size);
-            OHA_SWAP(iter->psl, psl);
-            OHA_SWAP(tmp_key_bucket->index, iter->index);
-        }
-#if OHA_MAX_LOG_N_PROBING
-        else if (psl > table->log2_of_indicies) {
-            // we need to resize the table, otherwise
-            // the key can be placed in not allocated memory
-            if (i_oha_lpht_grow(table) != 0) {
-                return NULL;
-            }
-            // try again
-            return oha_lpht_insert_int(table, key);
-        }
-#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+OHA_PRIVATE_API int
+i_oha_lpht_trace_write(struct oha_lpht_trace * const trace)
+{
+    assert(trace);
+    const size_t records = trace->records_in_use;
+    trace->records_in_use = 0;
+    if (records == 0) {
+        return 0;
+    }
+    if (fwrite(trace->records, trace->record_size, records, trace->file) != records) {
+        trace->write_failed = true;
+    }
+    return trace->write_failed ? -1 : 0;
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_trace(const struct oha_lpht * const table, const char operation, const void * const key)
+{
+    struct oha_lpht_trace * const trace = table->trace;
+    if (trace == NULL) {
+        return;
     }
+
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    const uint64_t time_stamp = (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+
+    uint8_t * const record = trace->records + trace->record_size * trace->records_in_use;
+    record[0] = (uint8_t)operation;
+    memcpy(record + 1, key, table->key_size);
+    memcpy(record + 1 + table->key_size, &time_stamp, sizeof(time_stamp));
+
+    trace->records_in_use++;
+    if (trace->records_in_use == trace->max_records) {
+        (void)i_oha_lpht_trace_write(trace);
+    }
+}
+
+OHA_FORCE_INLINE int
+oha_lpht_trace_start_int(struct oha_lpht * const table, const char * const file_path, uint32_t buffer_records)
+{
+    assert(table && file_path);
+    if (table->trace != NULL || buffer_records == 0) {
+        return -1;
+    }
+
+    const struct oha_memory_fp * memory = &table->memory;
+    struct oha_lpht_trace * const trace = (struct oha_lpht_trace *)oha_calloc(memory, sizeof(struct oha_lpht_trace));
+    if (trace == NULL) {
+        return -2;
+    }
+    trace->record_size = 1 + table->key_size + sizeof(uint64_t);
+    trace->max_records = buffer_records;
+    trace->records = (uint8_t *)oha_malloc(memory, trace->record_size * buffer_records);
+    if (trace->records == NULL) {
+        oha_free(memory, trace);
+        return -3;
+    }
+    trace->file = fopen(file_path, "wb");
+    if (trace->file == NULL) {
+        oha_free(memory, trace->records);
+        oha_free(memory, trace);
+        return -4;
+    }
+
+    table->trace = trace;
+    return 0;
 }
 
+OHA_FORCE_INLINE int
+oha_lpht_trace_flush_int(struct oha_lpht * const table)
+{
+    assert(table);
+    if (table->trace == NULL) {
+        return -1;
+    }
+    if (i_oha_lpht_trace_write(table->trace) != 0) {
+        return -2;
+    }
+    return fflush(table->trace->file) == 0 ? 0 : -3;
+}
+
+OHA_FORCE_INLINE int
+oha_lpht_trace_stop_int(struct oha_lpht * const table)
+{
+    assert(table);
+    struct oha_lpht_trace * const trace = table->trace;
+    if (trace == NULL) {
+        return -1;
+    }
+
+    int ret = i_oha_lpht_trace_write(trace) == 0 ? 0 : -2;
+    if (fclose(trace->file) != 0 && ret == 0) {
+        ret = -3;
+    }
+    oha_free(&table->memory, trace->records);
+    oha_free(&table->memory, trace);
+    table->trace = NULL;
+    return ret;
+}
+#endif
+
 OHA_FORCE_INLINE void
 oha_lpht_destroy_int(struct oha_lpht * const table)
 {
     assert(table);
     const struct oha_memory_fp * memory = &table->memory;
 
+#ifdef OHA_WITH_TRACE_SUPPORT
+    (void)oha_lpht_trace_stop_int(table);
+#endif
     i_oha_lpht_clean_up(table);
     oha_free(memory, table);
 }
@@ -382,12 +1207,31 @@ oha_lpht_create_int(const struct oha_lpht_config * const config)
         config->max_load_factor >= 1.0) {
         return NULL;
     }
+    const float growth_factor = config->growth_factor == 0 ? 2.0F : config->growth_factor;
+    if (growth_factor <= 1.0F || config->shrink_load_factor < 0 ||
+        config->shrink_load_factor >= config->max_load_factor / growth_factor) {
+        return NULL;
+    }
+    // every growth allocates a value buffer, the buffer id limits their number. A growth adds at least one element,
+    // so small tables need up to 1 / (growth_factor - 1) additional steps.
+    if (config->resizable) {
+        const double growth_steps =
+            log((double)UINT32_MAX / config->max_elems) / log(growth_factor) + 1.0 / (growth_factor - 1.0);
+        if (growth_steps >= OHA_LPHT_MAX_VALUE_BUFFERS - 1) {
+            return NULL;
+        }
+    }
+
+    // the probe sequence length is stored as int16_t
+    if (config->max_probe_length > INT16_MAX) {
+        return NULL;
+    }
 
     if (config->key_size < 4) {
         return NULL;
     }
 
-    struct oha_lpht * const table = oha_calloc(&config->memory, sizeof(struct oha_lpht));
+    struct oha_lpht * const table = (struct oha_lpht *)oha_calloc(&config->memory, sizeof(struct oha_lpht));
     if (table == NULL) {
         return NULL;
     }
@@ -395,12 +1239,31 @@ oha_lpht_create_int(const struct oha_lpht_config * const config)
     // copy config
     table->key_size = config->key_size;
     table->key_bucket_size = OHA_ALIGN_UP(sizeof(struct oha_lpht_key_bucket) + config->key_size);
+    table->key_bucket_size_shift = OHA_CTZ64(table->key_bucket_size);
+    table->key_bucket_size_inverse = oha_inverse_of_odd_64bit(table->key_bucket_size >> table->key_bucket_size_shift);
     table->value_bucket_size = OHA_ALIGN_UP(config->value_size);
+    if (config->insertion_ordered) {
+        table->order_index_offset = table->value_bucket_size;
+        table->value_bucket_size += OHA_ALIGN_UP(sizeof(uint32_t));
+        table->order_entry_size = OHA_ALIGN_UP(sizeof(struct oha_lpht_order_entry) + config->key_size);
+    }
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+    table->value_bucket_size += OHA_ALIGN_UP(config->key_size);
+#endif
     table->max_load_factor = config->max_load_factor;
     table->memory = config->memory;
     table->resizable = config->resizable;
-    table->max_load_factor = OHA_MAX(0.5, config->max_load_factor);
+    table->filter_bits_per_elem = config->filter_bits_per_elem;
+    table->occupied_bitmap = config->occupied_bitmap;
+    table->block_backward_shift = config->block_backward_shift;
+    table->growth_factor = growth_factor;
+    table->fast_range = growth_factor != 2.0F;
+    table->shrink_load_factor = config->shrink_load_factor;
+    table->grow_probe_length = config->grow_probe_length;
+    table->max_probe_length = config->max_probe_length;
     i_oha_lpht_calc_storage(table, config->max_elems);
+    table->min_elems = config->max_elems;
+    table->min_indicies = table->max_indicies;
 
     if (0 != i_oha_lpht_init_table(table)) {
         oha_free(&config->memory, table);
@@ -411,17 +1274,24 @@ oha_lpht_create_int(const struct oha_lpht_config * const config)
 
 // return pointer to value
 OHA_FORCE_INLINE struct oha_lpht_key_bucket *
-oha_lpht_look_up_int(const struct oha_lpht * const table, const void * const key)
+i_oha_lpht_look_up_sized(const struct oha_lpht * const table,
+                         const void * const key,
+                         const uint32_t hash,
+                         const size_t key_size)
 {
     assert(table);
     assert(key);
-    uint32_t hash = i_oha_lpht_hash_key(table, key);
-    // TODO add check for max prob counter
+    assert(key_size == table->key_size);
+
+    if (!i_oha_lpht_filter_may_contain(table, hash)) {
+        return NULL;
+    }
 
+    const uint8_t hash_tag = i_oha_lpht_hash_tag(hash);
     struct oha_lpht_key_bucket * iter = i_oha_lpht_get_start_bucket(table, hash);
     for (int32_t psl = 0; psl <= iter->psl; iter = i_oha_lpht_get_next_bucket(table, iter), ++psl) {
-        // circle + length check
-        if (memcmp(iter->key_buffer, key, table->key_size) == 0) {
+        // circle + length check, buckets with a higher psl belong to another start bucket
+        if (iter->psl == psl && i_oha_lpht_is_key_equal_sized(iter, key, hash_tag, key_size)) {
             return iter;
         }
     }
@@ -429,30 +1299,338 @@ oha_lpht_look_up_int(const struct oha_lpht * const table, const void * const key
 }
 
 // return pointer to value
+OHA_FORCE_INLINE struct oha_lpht_key_bucket *
+i_oha_lpht_look_up_hashed(const struct oha_lpht * const table, const void * const key, const uint32_t hash)
+{
+    return i_oha_lpht_look_up_sized(table, key, hash, table->key_size);
+}
+
+// return pointer to value
+OHA_FORCE_INLINE struct oha_lpht_key_bucket *
+oha_lpht_look_up_int(const struct oha_lpht * const table, const void * const key)
+{
+    return i_oha_lpht_look_up_hashed(table, key, i_oha_lpht_hash_key(table, key));
+}
+
+/*
+ * Look up optimized for misses: the probing stops at the first bucket of a richer key, only buckets of the same
+ * start bucket (and hash tag with OHA_WITH_HASH_TAGS) are compared and the value buckets are never touched.
+ */
+OHA_FORCE_INLINE bool
+i_oha_lpht_contains_sized(const struct oha_lpht * const table,
+                          const void * const key,
+                          const uint32_t hash,
+                          const size_t key_size)
+{
+    assert(table);
+    assert(key);
+    assert(key_size == table->key_size);
+    if (!i_oha_lpht_filter_may_contain(table, hash)) {
+        return false;
+    }
+    const uint8_t hash_tag = i_oha_lpht_hash_tag(hash);
+
+    const struct oha_lpht_key_bucket * iter = i_oha_lpht_get_start_bucket(table, hash);
+    for (int32_t psl = 0; psl <= iter->psl; iter = i_oha_lpht_get_next_bucket(table, iter), ++psl) {
+        if (iter->psl == psl && i_oha_lpht_is_key_equal_sized(iter, key, hash_tag, key_size)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+OHA_FORCE_INLINE bool
+oha_lpht_contains_int(const struct oha_lpht * const table, const void * const key)
+{
+    return i_oha_lpht_contains_sized(table, key, i_oha_lpht_hash_key(table, key), table->key_size);
+}
+
+OHA_FORCE_INLINE void
+i_oha_lpht_look_up_start(const struct oha_lpht * const table,
+                         struct i_oha_lpht_look_up_state * const state,
+                         const void * const keys,
+                         const size_t key_index)
+{
+    state->key = (const uint8_t *)oha_move_ptr_num_bytes(keys, table->key_size * key_index);
+    state->key_index = key_index;
+    state->hash = i_oha_lpht_hash_key(table, state->key);
+    state->psl = 0;
+    if (table->filter != NULL) {
+        OHA_PREFETCH(i_oha_lpht_filter_get_block(table->filter, table->filter_blocks_mask, state->hash));
+        state->stage = OHA_LPHT_LOOK_UP_FILTER;
+    } else {
+        state->bucket = i_oha_lpht_get_start_bucket(table, state->hash);
+        OHA_PREFETCH(state->bucket);
+        state->stage = OHA_LPHT_LOOK_UP_PROBE;
+    }
+}
+
+/*
+ * Runs one look up until it is done or has to wait for memory. Each step compares all buckets of the cached line,
+ * prefetches the next line and yields, so a long probe sequence does not stall the other look ups.
+ */
+OHA_FORCE_INLINE void
+i_oha_lpht_look_up_step(const struct oha_lpht * const table,
+                        struct i_oha_lpht_look_up_state * const state,
+                        void ** const values)
+{
+    if (state->stage == OHA_LPHT_LOOK_UP_FILTER) {
+        if (!i_oha_lpht_filter_may_contain(table, state->hash)) {
+            values[state->key_index] = NULL;
+            state->stage = OHA_LPHT_LOOK_UP_DONE;
+            return;
+        }
+        state->bucket = i_oha_lpht_get_start_bucket(table, state->hash);
+        OHA_PREFETCH(state->bucket);
+        state->stage = OHA_LPHT_LOOK_UP_PROBE;
+        return;
+    }
+
+    const uint8_t hash_tag = i_oha_lpht_hash_tag(state->hash);
+    const struct oha_lpht_key_bucket * iter = state->bucket;
+    for (;;) {
+        if (state->psl > iter->psl) {
+            values[state->key_index] = NULL;
+            state->stage = OHA_LPHT_LOOK_UP_DONE;
+            return;
+        }
+        if (iter->psl == state->psl && i_oha_lpht_is_key_equal(table, iter, state->key, hash_tag)) {
+            // the value bucket is the last dependent memory access, the caller gets it prefetched
+            void * const value = i_oha_lpht_get_value(table, iter);
+            OHA_PREFETCH(value);
+            values[state->key_index] = value;
+            state->stage = OHA_LPHT_LOOK_UP_DONE;
+            return;
+        }
+        const struct oha_lpht_key_bucket * const next = i_oha_lpht_get_next_bucket(table, iter);
+        state->psl++;
+        if ((uintptr_t)next / OHA_LPHT_CACHE_LINE_SIZE != (uintptr_t)iter / OHA_LPHT_CACHE_LINE_SIZE) {
+            state->bucket = next;
+            OHA_PREFETCH(next);
+            return;
+        }
+        iter = next;
+    }
+}
+
+/*
+ * Interleaved look up (asynchronous memory access chaining): up to OHA_LPHT_BATCH_SIZE look ups are in flight as
+ * small state machines. Each one prefetches its next cache line and yields to the others, a finished look up takes
+ * the next key. Unlike prefetching only the start buckets, this also hides the misses of longer probe sequences.
+ */
+OHA_FORCE_INLINE uint32_t
+oha_lpht_look_up_batch_int(const struct oha_lpht * const table,
+                           const void * const keys,
+                           const size_t num_keys,
+                           void ** const values)
+{
+    assert(table && keys && values);
+
+    struct i_oha_lpht_look_up_state states[OHA_LPHT_BATCH_SIZE];
+    size_t next_key = 0;
+    size_t in_flight = 0;
+    for (; in_flight < OHA_LPHT_BATCH_SIZE && next_key < num_keys; in_flight++, next_key++) {
+        i_oha_lpht_look_up_start(table, &states[in_flight], keys, next_key);
+    }
+
+    uint32_t found = 0;
+    while (in_flight > 0) {
+        for (size_t i = 0; i < in_flight;) {
+            struct i_oha_lpht_look_up_state * const state = &states[i];
+            i_oha_lpht_look_up_step(table, state, values);
+            if (state->stage != OHA_LPHT_LOOK_UP_DONE) {
+                i++;
+                continue;
+            }
+            found += values[state->key_index] != NULL;
+            if (next_key < num_keys) {
+                i_oha_lpht_look_up_start(table, state, keys, next_key++);
+                i++;
+            } else {
+                // keep the active look ups dense, the last one is stepped next at this position
+                *state = states[--in_flight];
+            }
+        }
+    }
+    return found;
+}
+
 OHA_PRIVATE_API struct oha_lpht_key_bucket *
-oha_lpht_insert_int(struct oha_lpht * const table, const void * const key)
+i_oha_lpht_insert_hashed(struct oha_lpht * const table,
+                         const void * const key,
+                         const uint32_t hash,
+                         bool * const inserted);
+
+// the key is not in the table, 'iter' is the first bucket behind the probed sequence of length 'psl'
+OHA_PRIVATE_API struct oha_lpht_key_bucket *
+i_oha_lpht_insert_missing(struct oha_lpht * const table,
+                          const void * const key,
+                          const uint32_t hash,
+                          const int32_t psl,
+                          struct oha_lpht_key_bucket * const iter,
+                          bool * const inserted)
+{
+    const uint8_t hash_tag = i_oha_lpht_hash_tag(hash);
+
+    if (table->elems >= table->max_elems) {
+        // grow the table and probe again, the insertion is completed by the nested call
+        if (i_oha_lpht_grow(table)) {
+            return NULL;
+        }
+        return i_oha_lpht_insert_hashed(table, key, hash, inserted);
+    }
+    // a long probe sequence lets a resizable table grow early, but not before it is half full
+    if (table->grow_probe_length > 0 && psl > table->grow_probe_length && table->resizable &&
+        table->elems >= table->max_elems / 2 && i_oha_lpht_grow(table) == 0) {
+        return i_oha_lpht_insert_hashed(table, key, hash, inserted);
+    }
+
+    // unfair, we need to apply the robin hood creed
+    // the new key was definite not in the table, otherwise we already found it, because of
+    // the robin hood invariant
+    *inserted = true;
+    struct oha_lpht_key_bucket * const inserted_bucket =
+        psl <= table->max_psl ? i_oha_lpht_robin_hood_emplace(table, key, hash_tag, psl, iter) : NULL;
+    if (inserted_bucket == NULL) {
+        // the probe sequence length bound is exceeded and nothing is moved yet, only a half full table grows,
+        // otherwise the key is rejected, so colliding keys can not let the table grow without a limit
+        if (table->resizable && table->elems >= table->max_elems / 2 && i_oha_lpht_grow(table) == 0) {
+            return i_oha_lpht_insert_hashed(table, key, hash, inserted);
+        }
+        return NULL;
+    }
+    if (table->filter != NULL) {
+        i_oha_lpht_filter_add(table->filter, table->filter_blocks_mask, hash);
+    }
+    if (table->order_entries != NULL) {
+        i_oha_lpht_order_append(table, key, i_oha_lpht_get_value(table, inserted_bucket));
+    }
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+    void * const value = i_oha_lpht_get_value(table, inserted_bucket);
+    memcpy(i_oha_lpht_get_key_of_value(table, value), key, table->key_size);
+#endif
+    return inserted_bucket;
+}
+
+// return pointer to value, inserted is set to false if the key was already in the table
+OHA_FORCE_INLINE struct oha_lpht_key_bucket *
+i_oha_lpht_insert_sized(struct oha_lpht * const table,
+                        const void * const key,
+                        const uint32_t hash,
+                        const size_t key_size,
+                        bool * const inserted)
 {
     assert(table);
     assert(key);
+    assert(inserted);
+    assert(key_size == table->key_size);
+
+    if (table->elems == 0) {
+        // the value of the last removed element is not readable anymore, so a drained table releases its memory
+        i_oha_lpht_shrink_if_sparse(table, -1);
+    }
 
-    uint32_t hash = i_oha_lpht_hash_key(table, key);
+    const uint8_t hash_tag = i_oha_lpht_hash_tag(hash);
     struct oha_lpht_key_bucket * iter = i_oha_lpht_get_start_bucket(table, hash);
 
     // do linear probing
     int32_t psl = 0;
-    for (; psl <= iter->psl; iter = i_oha_lpht_get_next_bucket(table, iter), ++psl) {
+    for (; psl <= table->max_psl && psl <= iter->psl; iter = i_oha_lpht_get_next_bucket(table, iter), ++psl) {
 
         // found a already inserted element
-        if (memcmp(iter->key_buffer, key, table->key_size) == 0) {
+        if (iter->psl == psl && i_oha_lpht_is_key_equal_sized(iter, key, hash_tag, key_size)) {
             // already inserted
+            *inserted = false;
             return iter;
         }
     }
+    return i_oha_lpht_insert_missing(table, key, hash, psl, iter, inserted);
+}
 
-    // unfair, we need to apply the robin hood creed
-    // the new key was definite not in the table, otherwise we already found it, because of
-    // the robin hood invariant
-    return i_oha_lpht_robin_hood_emplace(table, key, psl, iter);
+// return pointer to value, inserted is set to false if the key was already in the table
+OHA_PRIVATE_API struct oha_lpht_key_bucket *
+i_oha_lpht_insert_hashed(struct oha_lpht * const table,
+                         const void * const key,
+                         const uint32_t hash,
+                         bool * const inserted)
+{
+    return i_oha_lpht_insert_sized(table, key, hash, table->key_size, inserted);
+}
+
+// return pointer to value
+OHA_PRIVATE_API struct oha_lpht_key_bucket *
+oha_lpht_insert_int(struct oha_lpht * const table, const void * const key)
+{
+    bool inserted;
+    return i_oha_lpht_insert_hashed(table, key, i_oha_lpht_hash_key(table, key), &inserted);
+}
+
+OHA_FORCE_INLINE void *
+oha_lpht_upsert_int(struct oha_lpht * const table,
+                    const void * const key,
+                    const oha_lpht_upsert_fp init,
+                    const oha_lpht_upsert_fp merge,
+                    void * const ctx)
+{
+    bool inserted;
+    struct oha_lpht_key_bucket * const bucket =
+        i_oha_lpht_insert_hashed(table, key, i_oha_lpht_hash_key(table, key), &inserted);
+    if (bucket == NULL) {
+        return NULL;
+    }
+    void * const value = i_oha_lpht_get_value(table, bucket);
+    const oha_lpht_upsert_fp callback = inserted ? init : merge;
+    if (callback != NULL) {
+        callback(key, value, ctx);
+    }
+    return value;
+}
+
+OHA_FORCE_INLINE int
+oha_lpht_insert_batch_int(struct oha_lpht * const table,
+                          const void * const keys,
+                          const size_t num_keys,
+                          void ** const values,
+                          bool * const inserted)
+{
+    assert(table && keys && values);
+
+    // a single growth check for the whole batch, it grows by at least one growth step, so a series of small batches
+    // on a full table does not rebuild it for every batch. If the reservation fails, the inserts grow on their own.
+    if (table->resizable && num_keys <= UINT32_MAX - table->elems) {
+        (void)i_oha_lpht_resize(table, table->elems + (uint32_t)num_keys);
+    }
+
+    int ret = 0;
+    uint32_t hashes[OHA_LPHT_BATCH_SIZE];
+    for (size_t offset = 0; offset < num_keys; offset += OHA_LPHT_BATCH_SIZE) {
+        const size_t block = OMA_MIN(num_keys - offset, OHA_LPHT_BATCH_SIZE);
+        const uint8_t * const block_keys = (const uint8_t *)oha_move_ptr_num_bytes(keys, table->key_size * offset);
+
+        // 1. hash all keys of the block and prefetch the start buckets
+        for (size_t i = 0; i < block; i++) {
+            hashes[i] = i_oha_lpht_hash_key(table, block_keys + table->key_size * i);
+            OHA_PREFETCH(i_oha_lpht_get_start_bucket(table, hashes[i]));
+        }
+
+        // 2. place the keys, the start buckets are hopefully in the cache now
+        for (size_t i = 0; i < block; i++) {
+            bool is_new = false;
+            struct oha_lpht_key_bucket * const bucket =
+                i_oha_lpht_insert_hashed(table, block_keys + table->key_size * i, hashes[i], &is_new);
+            if (bucket != NULL) {
+                values[offset + i] = i_oha_lpht_get_value(table, bucket);
+            } else {
+                values[offset + i] = NULL;
+                ret = -1;
+            }
+            if (inserted != NULL) {
+                inserted[offset + i] = is_new && bucket != NULL;
+            }
+        }
+    }
+
+    return ret;
 }
 
 OHA_FORCE_INLINE int
@@ -461,6 +1639,7 @@ oha_lpht_iter_init_int(struct oha_lpht * const table)
     assert(table);
 
     table->iter = table->key_buckets;
+    table->iter_index = 0;
     return 0;
 }
 
@@ -475,35 +1654,89 @@ oha_lpht_iter_next_int(struct oha_lpht * const table, struct oha_key_value_pair
         return -2;
     }
 
-    bool stop = false;
-
-    while (table->iter <= table->last_key_bucket) {
-        if (i_oha_lpht_is_occupied(table->iter)) {
-            pair->key = table->iter->key_buffer;
-            pair->value = i_oha_lpht_get_value(table, table->iter);
-            stop = true;
+    if (table->order_entries != NULL) {
+        // skip the gaps of removed elements
+        while (table->iter_index < table->order_entries_in_use) {
+            struct oha_lpht_order_entry * const entry = i_oha_lpht_order_get_entry(table, table->iter_index++);
+            if (entry->value != NULL) {
+                pair->key = entry->key_buffer;
+                pair->value = entry->value;
+                return 0;
+            }
         }
-        table->iter = oha_move_ptr_num_bytes(table->iter, table->key_bucket_size);
-        if (stop == true) {
-            break;
+        return 1;
+    }
+
+    table->iter_index = i_oha_lpht_next_occupied(table, table->iter_index);
+    if (table->iter_index >= table->max_indicies) {
+        return 1;
+    }
+    const struct oha_lpht_key_bucket * const bucket = i_oha_lpht_get_bucket(table, table->iter_index++);
+    pair->key = (void *)bucket->key_buffer;
+    pair->value = i_oha_lpht_get_value(table, bucket);
+    return 0;
+}
+
+// moves each contiguous part of the cluster behind the removed bucket with a single memmove
+OHA_FORCE_INLINE void
+i_oha_lpht_block_backward_shift(struct oha_lpht * const table, struct oha_lpht_key_bucket * const bucket_to_remove)
+{
+    const uint32_t removed_index = bucket_to_remove->index;
+    const uint8_t removed_buffer_id = bucket_to_remove->buffer_id;
+
+    // 1. decrement the psl of all buckets to move, they are moved afterwards as they are
+    size_t num_buckets = 0;
+    struct oha_lpht_key_bucket * iter = i_oha_lpht_get_next_bucket(table, bucket_to_remove);
+    for (; iter->psl > 0; iter = i_oha_lpht_get_next_bucket(table, iter), num_buckets++) {
+        iter->psl--;
+    }
+
+    // 2. move the buckets, a cluster which wraps around the end of the table is moved in two parts
+    struct oha_lpht_key_bucket * last = bucket_to_remove;
+    if (num_buckets > 0) {
+        const size_t buckets_to_end =
+            (size_t)((uint8_t *)table->last_key_bucket - (uint8_t *)bucket_to_remove) / table->key_bucket_size;
+        const size_t first_part = OMA_MIN(num_buckets, buckets_to_end);
+        memmove(bucket_to_remove,
+                oha_move_ptr_num_bytes(bucket_to_remove, table->key_bucket_size),
+                first_part * table->key_bucket_size);
+        last = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(bucket_to_remove,
+                                                                     first_part * table->key_bucket_size);
+        if (first_part < num_buckets) {
+            const size_t second_part = num_buckets - first_part - 1;
+            memcpy(table->last_key_bucket, table->key_buckets, table->key_bucket_size);
+            memmove(table->key_buckets,
+                    oha_move_ptr_num_bytes(table->key_buckets, table->key_bucket_size),
+                    second_part * table->key_bucket_size);
+            last = (struct oha_lpht_key_bucket *)oha_move_ptr_num_bytes(table->key_buckets,
+                                                                         second_part * table->key_bucket_size);
         }
     }
 
-    return stop != true;
+    // 3. the last bucket of the cluster takes the value bucket of the removed element
+    last->psl = OHA_LPHT_EMPTY_BUCKET;
+    last->index = removed_index;
+    last->buffer_id = removed_buffer_id;
+    i_oha_lpht_mark_empty(table, last);
 }
 
-// return true if element was in the table
+// removes the element of the bucket and returns the pointer to its value
 OHA_FORCE_INLINE void *
-oha_lpht_remove_int(struct oha_lpht * const table, const void * const key)
+i_oha_lpht_remove_bucket(struct oha_lpht * const table, struct oha_lpht_key_bucket * const bucket_to_remove)
 {
-    assert(table && key);
-    struct oha_lpht_key_bucket * bucket_to_remove = oha_lpht_look_up_int(table, key);
-    if (bucket_to_remove == NULL) {
-        return NULL;
+    assert(table && bucket_to_remove);
+    assert(i_oha_lpht_is_occupied(bucket_to_remove));
+
+    void * const value = i_oha_lpht_get_value(table, bucket_to_remove);
+    if (table->order_entries != NULL) {
+        i_oha_lpht_order_remove(table, value);
     }
 
-    const uint32_t value_bucket_index = bucket_to_remove->index;
-    const uint16_t buffer_id = bucket_to_remove->buffer_id;
+    if (table->block_backward_shift) {
+        i_oha_lpht_block_backward_shift(table, bucket_to_remove);
+        table->elems--;
+        return value;
+    }
 
     // remove bucket
     bucket_to_remove->psl = OHA_LPHT_EMPTY_BUCKET;
@@ -514,17 +1747,230 @@ oha_lpht_remove_int(struct oha_lpht * const table, const void * const key)
 
         // back shift and decrement psl
         memcpy(iter->key_buffer, iter_next->key_buffer, table->key_size);
-        OHA_SWAP(iter->index, iter_next->index);
+        i_oha_lpht_set_hash_tag(iter, i_oha_lpht_get_hash_tag(iter_next));
+        i_oha_lpht_swap_value_ref(iter, iter_next);
         iter->psl = iter_next->psl - 1;
         iter_next->psl = OHA_LPHT_EMPTY_BUCKET;
 
         iter = iter_next;
         iter_next = i_oha_lpht_get_next_bucket(table, iter);
     };
+    // the last moved bucket or the removed bucket itself
+    i_oha_lpht_mark_empty(table, iter);
 
     table->elems--;
 
-    return oha_move_ptr_num_bytes(table->value_pool.buffers[buffer_id].data, table->value_bucket_size * value_bucket_index);
+    return value;
+}
+
+/*
+ * A bloom filter can not forget keys, so it is rebuild after enough removes to keep the false positive rate low.
+ * The rebuild touches all key buckets, but only every max_elems / 2 removes.
+ */
+OHA_PRIVATE_API void
+i_oha_lpht_filter_removed(struct oha_lpht * const table, const uint32_t removed)
+{
+    if (table->filter == NULL) {
+        return;
+    }
+    table->filter_stale += removed;
+    if (table->filter_stale <= table->max_elems / 2) {
+        return;
+    }
+
+    memset(table->filter, 0, i_oha_lpht_filter_size(table));
+    for (uint32_t i = i_oha_lpht_next_occupied(table, 0); i < table->max_indicies;
+         i = i_oha_lpht_next_occupied(table, i + 1)) {
+        const struct oha_lpht_key_bucket * const bucket = i_oha_lpht_get_bucket(table, i);
+        i_oha_lpht_filter_add(table->filter, table->filter_blocks_mask, i_oha_lpht_hash_key(table, bucket->key_buffer));
+    }
+    table->filter_stale = 0;
+}
+
+// return the value of the removed element
+OHA_FORCE_INLINE void *
+i_oha_lpht_remove_sized(struct oha_lpht * const table,
+                        const void * const key,
+                        const uint32_t hash,
+                        const size_t key_size)
+{
+    assert(table && key);
+    struct oha_lpht_key_bucket * bucket_to_remove = i_oha_lpht_look_up_sized(table, key, hash, key_size);
+    if (bucket_to_remove == NULL) {
+        return NULL;
+    }
+    const uint8_t buffer_id = bucket_to_remove->buffer_id;
+    void * const value = i_oha_lpht_remove_bucket(table, bucket_to_remove);
+    i_oha_lpht_filter_removed(table, 1);
+    i_oha_lpht_shrink_if_sparse(table, buffer_id);
+    return value;
+}
+
+// return the value of the removed element
+OHA_FORCE_INLINE void *
+i_oha_lpht_remove_hashed(struct oha_lpht * const table, const void * const key, const uint32_t hash)
+{
+    return i_oha_lpht_remove_sized(table, key, hash, table->key_size);
+}
+
+// return true if element was in the table
+OHA_FORCE_INLINE void *
+oha_lpht_remove_int(struct oha_lpht * const table, const void * const key)
+{
+    assert(table && key);
+    return i_oha_lpht_remove_hashed(table, key, i_oha_lpht_hash_key(table, key));
+}
+
+OHA_FORCE_INLINE uint32_t
+oha_lpht_remove_batch_int(struct oha_lpht * const table,
+                          const void * const keys,
+                          const size_t num_keys,
+                          void ** const values)
+{
+    assert(table && keys);
+    i_oha_lpht_shrink_if_sparse(table, -1);
+
+    uint32_t removed = 0;
+    uint32_t hashes[OHA_LPHT_BATCH_SIZE];
+    for (size_t offset = 0; offset < num_keys; offset += OHA_LPHT_BATCH_SIZE) {
+        const size_t block = OMA_MIN(num_keys - offset, OHA_LPHT_BATCH_SIZE);
+        const uint8_t * const block_keys = (const uint8_t *)oha_move_ptr_num_bytes(keys, table->key_size * offset);
+
+        // 1. hash all keys of the block and prefetch the start buckets
+        for (size_t i = 0; i < block; i++) {
+            hashes[i] = i_oha_lpht_hash_key(table, block_keys + table->key_size * i);
+            OHA_PREFETCH(i_oha_lpht_get_start_bucket(table, hashes[i]));
+        }
+
+        // 2. remove the keys, the start buckets are hopefully in the cache now
+        for (size_t i = 0; i < block; i++) {
+            struct oha_lpht_key_bucket * const bucket =
+                i_oha_lpht_look_up_hashed(table, block_keys + table->key_size * i, hashes[i]);
+            void * value = NULL;
+            if (bucket != NULL) {
+                value = i_oha_lpht_remove_bucket(table, bucket);
+                removed++;
+            }
+            if (values != NULL) {
+                values[offset + i] = value;
+            }
+        }
+    }
+
+    i_oha_lpht_filter_removed(table, removed);
+    // the returned values could be spread over all value buffers, so a sparse table shrinks by the next call
+    if (values == NULL) {
+        i_oha_lpht_shrink_if_sparse(table, -1);
+    }
+    return removed;
+}
+
+OHA_FORCE_INLINE struct oha_lpht_key_bucket *
+i_oha_lpht_advance_bucket(const struct oha_lpht * const table, struct oha_lpht_key_bucket * bucket, uint32_t steps)
+{
+    for (; steps > 0; steps--) {
+        bucket = i_oha_lpht_get_next_bucket(table, bucket);
+    }
+    return bucket;
+}
+
+/*
+ * Removes all elements matching the predicate in a single sweep over the key buckets. Instead of a back shift per
+ * removed element, every remaining element is moved only once into the gap in front of it, as far as its psl allows.
+ */
+OHA_FORCE_INLINE uint32_t
+oha_lpht_erase_if_int(struct oha_lpht * const table, const oha_lpht_erase_predicate_fp predicate, void * const ctx)
+{
+    assert(table && predicate);
+
+    // start at the begin of a cluster, no element in front of it belongs to the following buckets
+    struct oha_lpht_key_bucket * iter = table->key_buckets;
+    while (iter->psl > 0) {
+        iter = i_oha_lpht_get_next_bucket(table, iter);
+    }
+
+    uint32_t erased = 0;
+    struct oha_lpht_key_bucket * hole = NULL; // first empty bucket in front of iter inside the current cluster
+    uint32_t gap = 0;                         // number of buckets between hole and iter
+
+    for (uint32_t i = 0; i < table->max_indicies; i++, iter = i_oha_lpht_get_next_bucket(table, iter)) {
+        if (!i_oha_lpht_is_occupied(iter)) {
+            // end of cluster
+            hole = NULL;
+            continue;
+        }
+
+        void * const value = i_oha_lpht_get_value(table, iter);
+        if (predicate(iter->key_buffer, value, ctx)) {
+#ifdef OHA_WITH_TRACE_SUPPORT
+            i_oha_lpht_trace(table, OHA_LPHT_TRACE_REMOVE, iter->key_buffer);
+#endif
+            if (table->order_entries != NULL) {
+                i_oha_lpht_order_remove(table, value);
+            }
+            iter->psl = OHA_LPHT_EMPTY_BUCKET;
+            i_oha_lpht_mark_empty(table, iter);
+            erased++;
+            if (hole == NULL) {
+                hole = iter;
+                gap = 0;
+            }
+        } else if (hole != NULL) {
+            const uint32_t shift = OMA_MIN(gap, (uint32_t)iter->psl);
+            if (shift == 0) {
+                // element is already at its start bucket
+                hole = NULL;
+                continue;
+            }
+
+            struct oha_lpht_key_bucket * const target = i_oha_lpht_advance_bucket(table, hole, gap - shift);
+            memcpy(target->key_buffer, iter->key_buffer, table->key_size);
+            i_oha_lpht_set_hash_tag(target, i_oha_lpht_get_hash_tag(iter));
+            i_oha_lpht_swap_value_ref(target, iter);
+            target->psl = iter->psl - shift;
+            iter->psl = OHA_LPHT_EMPTY_BUCKET;
+            i_oha_lpht_mark_occupied(table, target);
+            i_oha_lpht_mark_empty(table, iter);
+
+            // all buckets behind the target up to iter are empty now
+            hole = i_oha_lpht_get_next_bucket(table, target);
+            gap = shift - 1;
+        }
+
+        if (hole != NULL) {
+            gap++;
+        }
+    }
+
+    table->elems -= erased;
+    i_oha_lpht_filter_removed(table, erased);
+    i_oha_lpht_shrink_if_sparse(table, -1);
+    return erased;
+}
+
+OHA_FORCE_INLINE void
+oha_lpht_clear_int(struct oha_lpht * const table)
+{
+    assert(table);
+
+    // every key bucket keeps its value bucket, so only the psl and the occupied bit of the occupied buckets need to
+    // be reset, the sweep stops behind the last element
+    uint32_t left = table->elems;
+    for (uint32_t i = i_oha_lpht_next_occupied(table, 0); left > 0; i = i_oha_lpht_next_occupied(table, i + 1)) {
+        assert(i < table->max_indicies);
+        struct oha_lpht_key_bucket * const bucket = i_oha_lpht_get_bucket(table, i);
+        bucket->psl = OHA_LPHT_EMPTY_BUCKET;
+        i_oha_lpht_mark_empty(table, bucket);
+        left--;
+    }
+
+    table->elems = 0;
+    table->iter = NULL;
+    if (table->filter != NULL) {
+        memset(table->filter, 0, i_oha_lpht_filter_size(table));
+        table->filter_stale = 0;
+    }
+    table->order_entries_in_use = 0;
 }
 
 OHA_FORCE_INLINE int
@@ -536,9 +1982,15 @@ oha_lpht_get_status_int(const struct oha_lpht * const table, struct oha_lpht_sta
     status->elems_in_use = table->elems;
     status->size_in_bytes =
         // key buckets
-        table->key_bucket_size * (table->max_indicies) +
-        // value buckets
-        table->value_bucket_size * (table->max_indicies) +
+        table->key_bucket_size * (table->max_indicies + OHA_LPHT_SENTINEL_BUCKETS) +
+        // value buckets of all buffers, also the free ones left over by a shrink
+        table->value_bucket_size * i_oha_lpht_value_buckets(table) +
+        // occupied bitmap
+        (table->occupied != NULL ? i_oha_lpht_occupied_size(table->max_indicies) : 0) +
+        // look up filter
+        (table->filter != NULL ? i_oha_lpht_filter_size(table) : 0) +
+        // insertion ordered entries
+        table->order_entry_size * table->max_order_entries +
         // table offset size
         sizeof(struct oha_lpht);
     status->current_load_factor = (float)table->elems / (float)(table->max_indicies);
@@ -581,6 +2033,9 @@ oha_lpht_look_up(const struct oha_lpht * const table, const void * const key)
     if (table == NULL || key == NULL) {
         return NULL;
     }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_LOOK_UP, key);
 #endif
     struct oha_lpht_key_bucket * bucket = oha_lpht_look_up_int(table, key);
     if (bucket != NULL) {
@@ -590,6 +2045,70 @@ oha_lpht_look_up(const struct oha_lpht * const table, const void * const key)
     return NULL;
 }
 
+OHA_PUBLIC_API uint32_t
+oha_lpht_hash_key(const struct oha_lpht * const table, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return 0;
+    }
+#endif
+    return i_oha_lpht_hash_key(table, key);
+}
+
+// return pointer to value
+OHA_PUBLIC_API void *
+oha_lpht_look_up_hashed(const struct oha_lpht * const table, const void * const key, const uint32_t hash)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    assert(hash == i_oha_lpht_hash_key(table, key));
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_LOOK_UP, key);
+#endif
+    struct oha_lpht_key_bucket * bucket = i_oha_lpht_look_up_hashed(table, key, hash);
+    if (bucket != NULL) {
+        return i_oha_lpht_get_value(table, bucket);
+    }
+    return NULL;
+}
+
+OHA_PUBLIC_API bool
+oha_lpht_contains(const struct oha_lpht * const table, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return false;
+    }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_LOOK_UP, key);
+#endif
+    return oha_lpht_contains_int(table, key);
+}
+
+OHA_PUBLIC_API uint32_t
+oha_lpht_look_up_batch(const struct oha_lpht * const table,
+                       const void * const keys,
+                       size_t num_keys,
+                       void ** const values)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || (num_keys > 0 && (keys == NULL || values == NULL))) {
+        return 0;
+    }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    for (size_t i = 0; i < num_keys; i++) {
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_LOOK_UP, oha_move_ptr_num_bytes(keys, table->key_size * i));
+    }
+#endif
+    return oha_lpht_look_up_batch_int(table, keys, num_keys, values);
+}
+
 // return pointer to value
 OHA_PUBLIC_API void *
 oha_lpht_insert(struct oha_lpht * const table, const void * const key)
@@ -598,6 +2117,9 @@ oha_lpht_insert(struct oha_lpht * const table, const void * const key)
     if (table == NULL || key == NULL) {
         return NULL;
     }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_INSERT, key);
 #endif
     struct oha_lpht_key_bucket * bucket = oha_lpht_insert_int(table, key);
     if (bucket != NULL) {
@@ -606,6 +2128,78 @@ oha_lpht_insert(struct oha_lpht * const table, const void * const key)
     return NULL;
 }
 
+// return pointer to value
+OHA_PUBLIC_API void *
+oha_lpht_insert_hashed(struct oha_lpht * const table, const void * const key, const uint32_t hash)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    assert(hash == i_oha_lpht_hash_key(table, key));
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_INSERT, key);
+#endif
+    bool inserted;
+    struct oha_lpht_key_bucket * bucket = i_oha_lpht_insert_hashed(table, key, hash, &inserted);
+    if (bucket != NULL) {
+        return i_oha_lpht_get_value(table, bucket);
+    }
+    return NULL;
+}
+
+OHA_PUBLIC_API void *
+oha_lpht_upsert(struct oha_lpht * const table,
+                const void * const key,
+                const oha_lpht_upsert_fp init,
+                const oha_lpht_upsert_fp merge,
+                void * const ctx)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_INSERT, key);
+#endif
+    return oha_lpht_upsert_int(table, key, init, merge, ctx);
+}
+
+OHA_PUBLIC_API int
+oha_lpht_insert_batch(struct oha_lpht * const table,
+                      const void * const keys,
+                      size_t num_keys,
+                      void ** const values,
+                      bool * const inserted)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || (num_keys > 0 && (keys == NULL || values == NULL))) {
+        return -1;
+    }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    for (size_t i = 0; i < num_keys; i++) {
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_INSERT, oha_move_ptr_num_bytes(keys, table->key_size * i));
+    }
+#endif
+    return oha_lpht_insert_batch_int(table, keys, num_keys, values, inserted);
+}
+
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+OHA_PUBLIC_API const void *
+oha_lpht_get_key_from_value(const struct oha_lpht * const table, const void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || value == NULL) {
+        return NULL;
+    }
+#endif
+    return i_oha_lpht_get_key_of_value(table, value);
+}
+#endif
+
 OHA_PUBLIC_API int
 oha_lpht_reserve(struct oha_lpht * const table, uint32_t elements)
 {
@@ -647,10 +2241,67 @@ oha_lpht_remove(struct oha_lpht * const table, const void * const key)
     if (table == NULL || key == NULL) {
         return NULL;
     }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_REMOVE, key);
 #endif
     return oha_lpht_remove_int(table, key);
 }
 
+// return the value of the removed element
+OHA_PUBLIC_API void *
+oha_lpht_remove_hashed(struct oha_lpht * const table, const void * const key, const uint32_t hash)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    assert(hash == i_oha_lpht_hash_key(table, key));
+#ifdef OHA_WITH_TRACE_SUPPORT
+    i_oha_lpht_trace(table, OHA_LPHT_TRACE_REMOVE, key);
+#endif
+    return i_oha_lpht_remove_hashed(table, key, hash);
+}
+
+OHA_PUBLIC_API uint32_t
+oha_lpht_remove_batch(struct oha_lpht * const table, const void * const keys, size_t num_keys, void ** const values)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || (num_keys > 0 && keys == NULL)) {
+        return 0;
+    }
+#endif
+#ifdef OHA_WITH_TRACE_SUPPORT
+    for (size_t i = 0; i < num_keys; i++) {
+        i_oha_lpht_trace(table, OHA_LPHT_TRACE_REMOVE, oha_move_ptr_num_bytes(keys, table->key_size * i));
+    }
+#endif
+    return oha_lpht_remove_batch_int(table, keys, num_keys, values);
+}
+
+OHA_PUBLIC_API uint32_t
+oha_lpht_erase_if(struct oha_lpht * const table, oha_lpht_erase_predicate_fp predicate, void * const ctx)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || predicate == NULL) {
+        return 0;
+    }
+#endif
+    return oha_lpht_erase_if_int(table, predicate, ctx);
+}
+
+OHA_PUBLIC_API void
+oha_lpht_clear(struct oha_lpht * const table)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL) {
+        return;
+    }
+#endif
+    oha_lpht_clear_int(table);
+}
+
 OHA_PUBLIC_API int
 oha_lpht_get_status(const struct oha_lpht * const table, struct oha_lpht_status * const status)
 {
@@ -662,4 +2313,39 @@ oha_lpht_get_status(const struct oha_lpht * const table, struct oha_lpht_status
     return oha_lpht_get_status_int(table, status);
 }
 
+#ifdef OHA_WITH_TRACE_SUPPORT
+OHA_PUBLIC_API int
+oha_lpht_trace_start(struct oha_lpht * const table, const char * const file_path, uint32_t buffer_records)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || file_path == NULL) {
+        return -1;
+    }
+#endif
+    return oha_lpht_trace_start_int(table, file_path, buffer_records);
+}
+
+OHA_PUBLIC_API int
+oha_lpht_trace_flush(struct oha_lpht * const table)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL) {
+        return -1;
+    }
+#endif
+    return oha_lpht_trace_flush_int(table);
+}
+
+OHA_PUBLIC_API int
+oha_lpht_trace_stop(struct oha_lpht * const table)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL) {
+        return -1;
+    }
+#endif
+    return oha_lpht_trace_stop_int(table);
+}
+#endif
+
 #endif
@@ -0,0 +1,405 @@
+#ifndef OHA_MULTI_QUEUE_H_
+#define OHA_MULTI_QUEUE_H_
+
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oha_utils.h"
+#include "oha_tpht_impl.h"
+
+#define OHA_MQ_CACHE_LINE_SIZE 64
+// elements expired per lock of a shard
+#define OHA_MQ_EXPIRE_BATCH_SIZE 16
+
+// every shard is a cache line, so the unlocked reads of the next deadline do not share lines with other locks
+struct oha_mq_shard {
+    struct oha_tpht * table;
+    int64_t next_deadline; // earliest deadline or INT64_MAX if the shard is empty, readable without the lock
+    bool lock;
+    uint8_t padding[OHA_MQ_CACHE_LINE_SIZE - sizeof(struct oha_tpht *) - sizeof(int64_t) - sizeof(bool)];
+};
+
+struct oha_mq {
+    struct oha_memory_fp memory;
+    struct oha_mq_shard * shards; // cache line aligned
+    void * shards_allocation;     // unaligned begin of the shard array
+    size_t key_size;
+    size_t value_size;
+    uint32_t num_shards;
+    // the counter is written by every consumer, the padding keeps it off the line of the fields above
+    uint8_t padding[OHA_MQ_CACHE_LINE_SIZE];
+    uint64_t pops; // counter for the random shard choices of the consumers
+};
+
+OHA_FORCE_INLINE bool
+i_oha_mq_try_lock(struct oha_mq_shard * const shard)
+{
+    return !__atomic_test_and_set(&shard->lock, __ATOMIC_ACQUIRE);
+}
+
+OHA_FORCE_INLINE void
+i_oha_mq_lock(struct oha_mq_shard * const shard)
+{
+    while (!i_oha_mq_try_lock(shard)) {
+        // spins on a shared cache line until the lock is released
+        while (__atomic_load_n(&shard->lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+OHA_FORCE_INLINE void
+i_oha_mq_unlock(struct oha_mq_shard * const shard)
+{
+    __atomic_clear(&shard->lock, __ATOMIC_RELEASE);
+}
+
+OHA_FORCE_INLINE int64_t
+i_oha_mq_next_deadline(const struct oha_mq_shard * const shard)
+{
+    return __atomic_load_n(&shard->next_deadline, __ATOMIC_RELAXED);
+}
+
+// is called with the lock of the shard after each change of the deadlines
+OHA_FORCE_INLINE void
+i_oha_mq_update_next_deadline(struct oha_mq_shard * const shard)
+{
+    int64_t deadline;
+    if (i_oha_tpht_deadlines_find_min(shard->table, &deadline) == NULL) {
+        deadline = INT64_MAX;
+    }
+    __atomic_store_n(&shard->next_deadline, deadline, __ATOMIC_RELAXED);
+}
+
+// maps a 32 bit random number to [0, num_shards)
+OHA_FORCE_INLINE struct oha_mq_shard *
+i_oha_mq_get_shard(const struct oha_mq * const mq, const uint32_t random)
+{
+    return &mq->shards[((uint64_t)random * mq->num_shards) >> 32];
+}
+
+// the hash is remixed, otherwise all keys of a shard would share the start buckets in the table of the shard
+OHA_FORCE_INLINE struct oha_mq_shard *
+i_oha_mq_get_key_shard(const struct oha_mq * const mq, const void * const key)
+{
+    return i_oha_mq_get_shard(mq, oha_lpht_hash_32bit(key, mq->key_size) * UINT32_C(0x9E3779B9));
+}
+
+// returns a shard with a due element or NULL, the scan starts at a random shard to spread the consumers
+OHA_FORCE_INLINE struct oha_mq_shard *
+i_oha_mq_find_due_shard(const struct oha_mq * const mq, const int64_t now, const uint32_t random)
+{
+    const uint32_t start = (uint32_t)(((uint64_t)random * mq->num_shards) >> 32);
+    for (uint32_t i = 0; i < mq->num_shards; i++) {
+        struct oha_mq_shard * const shard = &mq->shards[(start + i) % mq->num_shards];
+        if (i_oha_mq_next_deadline(shard) <= now) {
+            return shard;
+        }
+    }
+    return NULL;
+}
+
+OHA_FORCE_INLINE void
+oha_mq_destroy_int(struct oha_mq * const mq)
+{
+    assert(mq);
+    for (uint32_t i = 0; i < mq->num_shards; i++) {
+        if (mq->shards[i].table != NULL) {
+            oha_tpht_destroy_int(mq->shards[i].table);
+        }
+    }
+    oha_free(&mq->memory, mq->shards_allocation);
+    oha_free(&mq->memory, mq);
+}
+
+OHA_FORCE_INLINE struct oha_mq *
+oha_mq_create_int(const struct oha_mq_config * const config)
+{
+    assert(config);
+    const struct oha_memory_fp * memory = &config->shard_config.table_config.memory;
+    if (config->num_shards == 0) {
+        return NULL;
+    }
+
+    struct oha_mq * const mq = (struct oha_mq *)oha_calloc(memory, sizeof(struct oha_mq));
+    if (mq == NULL) {
+        return NULL;
+    }
+    mq->memory = *memory;
+    mq->key_size = config->shard_config.table_config.key_size;
+    mq->value_size = config->shard_config.table_config.value_size;
+    mq->num_shards = config->num_shards;
+
+    mq->shards_allocation =
+        oha_calloc(memory, sizeof(struct oha_mq_shard) * config->num_shards + OHA_MQ_CACHE_LINE_SIZE);
+    if (mq->shards_allocation == NULL) {
+        oha_free(memory, mq);
+        return NULL;
+    }
+    mq->shards = (struct oha_mq_shard *)(((uintptr_t)mq->shards_allocation + OHA_MQ_CACHE_LINE_SIZE - 1) &
+                                         ~(uintptr_t)(OHA_MQ_CACHE_LINE_SIZE - 1));
+    for (uint32_t i = 0; i < mq->num_shards; i++) {
+        mq->shards[i].next_deadline = INT64_MAX;
+        mq->shards[i].table = oha_tpht_create_int(&config->shard_config);
+        if (mq->shards[i].table == NULL) {
+            oha_mq_destroy_int(mq);
+            return NULL;
+        }
+    }
+    return mq;
+}
+
+OHA_FORCE_INLINE int
+oha_mq_insert_int(struct oha_mq * const mq,
+                  const void * const key,
+                  const void * const value,
+                  const int64_t deadline,
+                  const int64_t now)
+{
+    assert(mq && key);
+    struct oha_mq_shard * const shard = i_oha_mq_get_key_shard(mq, key);
+    i_oha_mq_lock(shard);
+
+    int result = -1;
+    bool inserted;
+    void * const element = oha_tpht_insert_int(shard->table, key, deadline, now, &inserted);
+    if (element != NULL && !inserted) {
+        // the element exists already and is not changed
+        result = 1;
+    } else if (element != NULL) {
+        if (value != NULL) {
+            memcpy(element, value, mq->value_size);
+        }
+        // a replaced element could have had the earliest deadline
+        i_oha_mq_update_next_deadline(shard);
+        result = 0;
+    }
+
+    i_oha_mq_unlock(shard);
+    return result;
+}
+
+OHA_FORCE_INLINE bool
+oha_mq_look_up_int(struct oha_mq * const mq, const void * const key, const int64_t now, void * const value)
+{
+    assert(mq && key);
+    struct oha_mq_shard * const shard = i_oha_mq_get_key_shard(mq, key);
+    i_oha_mq_lock(shard);
+
+    const void * const found = oha_tpht_look_up_int(shard->table, key, now);
+    if (found != NULL && value != NULL) {
+        memcpy(value, found, mq->value_size);
+    }
+
+    i_oha_mq_unlock(shard);
+    return found != NULL;
+}
+
+OHA_FORCE_INLINE bool
+oha_mq_remove_int(struct oha_mq * const mq, const void * const key, void * const value)
+{
+    assert(mq && key);
+    struct oha_mq_shard * const shard = i_oha_mq_get_key_shard(mq, key);
+    i_oha_mq_lock(shard);
+
+    const void * const removed = oha_tpht_remove_int(shard->table, key);
+    if (removed != NULL) {
+        if (value != NULL) {
+            memcpy(value, removed, mq->value_size);
+        }
+        i_oha_mq_update_next_deadline(shard);
+    }
+
+    i_oha_mq_unlock(shard);
+    return removed != NULL;
+}
+
+OHA_FORCE_INLINE int
+oha_mq_set_deadline_int(struct oha_mq * const mq, const void * const key, const int64_t deadline)
+{
+    assert(mq && key);
+    struct oha_mq_shard * const shard = i_oha_mq_get_key_shard(mq, key);
+    i_oha_mq_lock(shard);
+
+    int result = -1;
+    const struct oha_lpht_key_bucket * const bucket = oha_lpht_look_up_int(shard->table->table, key);
+    if (bucket != NULL) {
+        result = oha_tpht_set_deadline_int(shard->table, i_oha_lpht_get_value(shard->table->table, bucket), deadline);
+        i_oha_mq_update_next_deadline(shard);
+    }
+
+    i_oha_mq_unlock(shard);
+    return result;
+}
+
+/*
+ * MultiQueue expiry: the consumer compares the next deadlines of two random shards and expires a batch of the
+ * earlier one. A locked shard is skipped instead of waited for, so the consumers spread over the shards. The order
+ * over all shards is relaxed, but no due element is left behind, since the shards are scanned before giving up.
+ */
+OHA_FORCE_INLINE uint32_t
+oha_mq_expire_int(struct oha_mq * const mq,
+                  const int64_t now,
+                  const uint32_t max_expired,
+                  const oha_tpht_expired_fp callback,
+                  void * const ctx)
+{
+    assert(mq);
+    uint32_t expired = 0;
+    while (expired < max_expired) {
+        uint64_t random = __atomic_fetch_add(&mq->pops, 1, __ATOMIC_RELAXED) * UINT64_C(0x9E3779B97F4A7C15);
+        random ^= random >> 29;
+
+        struct oha_mq_shard * shard = i_oha_mq_get_shard(mq, (uint32_t)random);
+        struct oha_mq_shard * const other = i_oha_mq_get_shard(mq, (uint32_t)(random >> 32));
+        if (i_oha_mq_next_deadline(other) < i_oha_mq_next_deadline(shard)) {
+            shard = other;
+        }
+        if (i_oha_mq_next_deadline(shard) > now) {
+            shard = i_oha_mq_find_due_shard(mq, now, (uint32_t)random);
+            if (shard == NULL) {
+                break;
+            }
+        }
+        if (!i_oha_mq_try_lock(shard)) {
+            continue;
+        }
+        // the deadlines could have changed since the unlocked read
+        expired += i_oha_tpht_expire(
+            shard->table, now, OMA_MIN(max_expired - expired, OHA_MQ_EXPIRE_BATCH_SIZE), callback, ctx);
+        i_oha_mq_update_next_deadline(shard);
+        i_oha_mq_unlock(shard);
+    }
+    return expired;
+}
+
+OHA_FORCE_INLINE int
+oha_mq_get_status_int(struct oha_mq * const mq, struct oha_lpht_status * const status)
+{
+    assert(mq && status);
+    memset(status, 0, sizeof(*status));
+    for (uint32_t i = 0; i < mq->num_shards; i++) {
+        struct oha_mq_shard * const shard = &mq->shards[i];
+        struct oha_lpht_status shard_status;
+        i_oha_mq_lock(shard);
+        const int error = oha_tpht_get_status_int(shard->table, &shard_status);
+        i_oha_mq_unlock(shard);
+        if (error != 0) {
+            return -1;
+        }
+        status->max_elems += shard_status.max_elems;
+        status->elems_in_use += shard_status.elems_in_use;
+        status->size_in_bytes += shard_status.size_in_bytes;
+        status->current_load_factor += shard_status.current_load_factor / (float)mq->num_shards;
+    }
+    status->size_in_bytes +=
+        sizeof(struct oha_mq) + sizeof(struct oha_mq_shard) * mq->num_shards + OHA_MQ_CACHE_LINE_SIZE;
+    return 0;
+}
+
+/**********************************************************************************************************************
+ *
+ * public interface functions section
+ *
+ *********************************************************************************************************************/
+
+OHA_PUBLIC_API struct oha_mq *
+oha_mq_create(const struct oha_mq_config * const config)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (config == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_mq_create_int(config);
+}
+
+OHA_PUBLIC_API void
+oha_mq_destroy(struct oha_mq * const mq)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL) {
+        return;
+    }
+#endif
+    oha_mq_destroy_int(mq);
+}
+
+OHA_PUBLIC_API int
+oha_mq_insert(struct oha_mq * const mq,
+              const void * const key,
+              const void * const value,
+              const int64_t deadline,
+              const int64_t now)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL || key == NULL) {
+        return -1;
+    }
+#endif
+    return oha_mq_insert_int(mq, key, value, deadline, now);
+}
+
+OHA_PUBLIC_API bool
+oha_mq_look_up(struct oha_mq * const mq, const void * const key, const int64_t now, void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL || key == NULL) {
+        return false;
+    }
+#endif
+    return oha_mq_look_up_int(mq, key, now, value);
+}
+
+OHA_PUBLIC_API bool
+oha_mq_remove(struct oha_mq * const mq, const void * const key, void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL || key == NULL) {
+        return false;
+    }
+#endif
+    return oha_mq_remove_int(mq, key, value);
+}
+
+OHA_PUBLIC_API int
+oha_mq_set_deadline(struct oha_mq * const mq, const void * const key, const int64_t deadline)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL || key == NULL) {
+        return -1;
+    }
+#endif
+    return oha_mq_set_deadline_int(mq, key, deadline);
+}
+
+OHA_PUBLIC_API uint32_t
+oha_mq_expire(struct oha_mq * const mq,
+              const int64_t now,
+              const uint32_t max_expired,
+              oha_tpht_expired_fp callback,
+              void * const ctx)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL) {
+        return 0;
+    }
+#endif
+    return oha_mq_expire_int(mq, now, max_expired, callback, ctx);
+}
+
+OHA_PUBLIC_API int
+oha_mq_get_status(struct oha_mq * const mq, struct oha_lpht_status * const status)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (mq == NULL || status == NULL) {
+        return -1;
+    }
+#endif
+    return oha_mq_get_status_int(mq, status);
+}
+
+#endif
@@ -0,0 +1,480 @@
+#ifndef OHA_RADIX_HEAP_H_
+#define OHA_RADIX_HEAP_H_
+
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oha_utils.h"
+
+/*
+ * Bucket 0 keeps the keys equal to the last minimum. The other keys are sorted by the highest digit different to
+ * the last minimum (level) and the value of this digit. A key moves only to lower levels, so a key is moved at most
+ * once per digit of the key range instead of once per bit.
+ */
+#define OHA_RXH_DIGIT_BITS 4
+#define OHA_RXH_DIGITS (1 << OHA_RXH_DIGIT_BITS)
+#define OHA_RXH_LEVELS (64 / OHA_RXH_DIGIT_BITS)
+#define OHA_RXH_NUM_BUCKETS (1 + OHA_RXH_LEVELS * OHA_RXH_DIGITS)
+#define OHA_RXH_FREE_NODE UINT16_MAX
+
+// stored in front of every value
+struct oha_rxh_node {
+    struct oha_rxh_node * next; // next node of the bucket or of the free list
+    struct oha_rxh_node * prev;
+    int64_t key;
+    uint16_t bucket; // OHA_RXH_FREE_NODE for removed nodes
+};
+
+struct oha_rxh {
+    struct oha_memory_fp memory;
+    struct oha_memory_pool value_pool;
+    struct oha_rxh_node * buckets[OHA_RXH_NUM_BUCKETS];
+    struct oha_rxh_node * free_nodes;  // the last removed node is reused first
+    uint16_t occupied_levels;          // bit l is set if a bucket of level l is not empty
+    uint16_t occupied[OHA_RXH_LEVELS]; // bit d of level l is set if the bucket of digit d is not empty
+    uint64_t last;                     // order preserving unsigned key of the last minimum
+    size_t node_size;                  // size in bytes of one node including the value, memory aligned
+    uint32_t elems;
+    uint32_t max_elems;
+    bool resizable;
+};
+
+OHA_FORCE_INLINE void *
+i_oha_rxh_get_value(struct oha_rxh_node * const node)
+{
+    return oha_move_ptr_num_bytes(node, OHA_ALIGN_UP(sizeof(struct oha_rxh_node)));
+}
+
+OHA_FORCE_INLINE struct oha_rxh_node *
+i_oha_rxh_get_node(const void * const value)
+{
+    return (struct oha_rxh_node *)((const uint8_t *)value - OHA_ALIGN_UP(sizeof(struct oha_rxh_node)));
+}
+
+// keys before the last minimum are ordered as the last minimum
+OHA_FORCE_INLINE uint64_t
+i_oha_rxh_ordered_key(const struct oha_rxh * const heap, const int64_t key)
+{
+    const uint64_t ordered = (uint64_t)key ^ (UINT64_C(1) << 63);
+    return OHA_MAX(ordered, heap->last);
+}
+
+OHA_FORCE_INLINE void
+i_oha_rxh_link(struct oha_rxh * const heap, struct oha_rxh_node * const node)
+{
+    const uint64_t key = i_oha_rxh_ordered_key(heap, node->key);
+    const uint64_t diff = key ^ heap->last;
+    uint16_t bucket = 0;
+    if (diff != 0) {
+        const uint32_t level = (63 - OHA_CLZ64(diff)) / OHA_RXH_DIGIT_BITS;
+        const uint32_t digit = (uint32_t)(key >> (level * OHA_RXH_DIGIT_BITS)) & (OHA_RXH_DIGITS - 1);
+        bucket = (uint16_t)(1 + level * OHA_RXH_DIGITS + digit);
+        heap->occupied_levels |= (uint16_t)(1U << level);
+        heap->occupied[level] |= (uint16_t)(1U << digit);
+    }
+    node->bucket = bucket;
+    node->prev = NULL;
+    node->next = heap->buckets[bucket];
+    if (node->next != NULL) {
+        node->next->prev = node;
+    }
+    heap->buckets[bucket] = node;
+}
+
+OHA_FORCE_INLINE void
+i_oha_rxh_clear_occupied(struct oha_rxh * const heap, const uint32_t bucket)
+{
+    const uint32_t level = (bucket - 1) / OHA_RXH_DIGITS;
+    heap->occupied[level] &= (uint16_t) ~(1U << ((bucket - 1) % OHA_RXH_DIGITS));
+    if (heap->occupied[level] == 0) {
+        heap->occupied_levels &= (uint16_t) ~(1U << level);
+    }
+}
+
+OHA_FORCE_INLINE void
+i_oha_rxh_unlink(struct oha_rxh * const heap, struct oha_rxh_node * const node)
+{
+    const uint16_t bucket = node->bucket;
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        heap->buckets[bucket] = node->next;
+        if (node->next == NULL && bucket > 0) {
+            i_oha_rxh_clear_occupied(heap, bucket);
+        }
+    }
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    }
+}
+
+OHA_FORCE_INLINE void
+i_oha_rxh_free_node(struct oha_rxh * const heap, struct oha_rxh_node * const node)
+{
+    node->bucket = OHA_RXH_FREE_NODE;
+    node->next = heap->free_nodes;
+    heap->free_nodes = node;
+    heap->elems--;
+}
+
+/*
+ * Moves the smallest keys into bucket 0. The last minimum is set to the lowest possible key of the lowest non empty
+ * bucket, so the keys of this bucket only differ in lower digits and move into lower levels. This is repeated until
+ * a key matches the last minimum, without a scan for the exact minimum per level.
+ */
+OHA_FORCE_INLINE void
+i_oha_rxh_pull(struct oha_rxh * const heap)
+{
+    assert(heap->buckets[0] == NULL && heap->occupied_levels != 0);
+    do {
+        const uint32_t level = OHA_CTZ64(heap->occupied_levels);
+        const uint32_t digit = OHA_CTZ64(heap->occupied[level]);
+        const uint32_t bucket = 1 + level * OHA_RXH_DIGITS + digit;
+        struct oha_rxh_node * node = heap->buckets[bucket];
+        heap->buckets[bucket] = NULL;
+        i_oha_rxh_clear_occupied(heap, bucket);
+
+        // keeps the higher digits, sets the digit of the level and clears the lower digits
+        const uint32_t shift = level * OHA_RXH_DIGIT_BITS;
+        const uint64_t higher_digits =
+            level + 1 < OHA_RXH_LEVELS ? ~UINT64_C(0) << (shift + OHA_RXH_DIGIT_BITS) : UINT64_C(0);
+        heap->last = (heap->last & higher_digits) | ((uint64_t)digit << shift);
+
+        while (node != NULL) {
+            struct oha_rxh_node * const next = node->next;
+            i_oha_rxh_link(heap, node);
+            node = next;
+        }
+    } while (heap->buckets[0] == NULL);
+}
+
+// connects all nodes of a new buffer to the free list
+OHA_FORCE_INLINE void
+i_oha_rxh_add_free_nodes(struct oha_rxh * const heap, uint8_t * const data, const uint32_t num)
+{
+    for (uint32_t i = num; i-- > 0;) {
+        struct oha_rxh_node * const node =
+            (struct oha_rxh_node *)oha_move_ptr_num_bytes(data, heap->node_size * i);
+        node->bucket = OHA_RXH_FREE_NODE;
+        node->next = heap->free_nodes;
+        heap->free_nodes = node;
+    }
+}
+
+OHA_FORCE_INLINE void
+i_oha_rxh_clean_up(struct oha_rxh * const heap)
+{
+    assert(heap);
+    const struct oha_memory_fp * memory = &heap->memory;
+
+    for (size_t i = 0; i < heap->value_pool.elems; i++) {
+        oha_free(memory, heap->value_pool.buffers[i].data);
+    }
+    if (heap->value_pool.buffers != NULL) {
+        oha_free(memory, heap->value_pool.buffers);
+    }
+}
+
+OHA_FORCE_INLINE int
+i_oha_rxh_init_heap(struct oha_rxh * const heap)
+{
+    const struct oha_memory_fp * memory = &heap->memory;
+    heap->value_pool.buffers = (struct oha_buffer *)oha_malloc(memory, sizeof(*heap->value_pool.buffers));
+    if (heap->value_pool.buffers == NULL) {
+        return -1;
+    }
+
+    uint8_t * const data = (uint8_t *)oha_malloc(memory, heap->node_size * heap->max_elems);
+    if (data == NULL) {
+        i_oha_rxh_clean_up(heap);
+        return -2;
+    }
+    heap->value_pool.buffers[0].data = data;
+    heap->value_pool.elems = 1;
+    i_oha_rxh_add_free_nodes(heap, data, heap->max_elems);
+    return 0;
+}
+
+// doubles the number of nodes, the nodes of the old buffers are not moved
+OHA_PRIVATE_API int
+i_oha_rxh_grow(struct oha_rxh * const heap)
+{
+    if (!heap->resizable) {
+        return -1;
+    }
+    if (heap->max_elems > UINT32_MAX / 2) {
+        return -2;
+    }
+
+    const struct oha_memory_fp * memory = &heap->memory;
+    const uint32_t new_elems = heap->max_elems;
+    uint8_t * const data = (uint8_t *)oha_malloc(memory, heap->node_size * new_elems);
+    if (data == NULL) {
+        return -3;
+    }
+
+    size_t num_buffers = heap->value_pool.elems;
+    if (!oha_add_entry_to_array(
+            memory, (void **)&heap->value_pool.buffers, sizeof(*heap->value_pool.buffers), &num_buffers)) {
+        oha_free(memory, data);
+        return -4;
+    }
+    heap->value_pool.buffers[heap->value_pool.elems].data = data;
+    heap->value_pool.elems = num_buffers;
+
+    i_oha_rxh_add_free_nodes(heap, data, new_elems);
+    heap->max_elems += new_elems;
+    return 0;
+}
+
+OHA_FORCE_INLINE void
+oha_rxh_destroy_int(struct oha_rxh * const heap)
+{
+    assert(heap);
+    const struct oha_memory_fp * memory = &heap->memory;
+    i_oha_rxh_clean_up(heap);
+    oha_free(memory, heap);
+}
+
+OHA_FORCE_INLINE struct oha_rxh *
+oha_rxh_create_int(const struct oha_rxh_config * const config)
+{
+    assert(config);
+    if (config->max_elems == 0) {
+        return NULL;
+    }
+
+    struct oha_rxh * const heap = (struct oha_rxh *)oha_calloc(&config->memory, sizeof(struct oha_rxh));
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    heap->memory = config->memory;
+    heap->node_size = OHA_ALIGN_UP(sizeof(struct oha_rxh_node)) + OHA_ALIGN_UP(config->value_size);
+    heap->max_elems = config->max_elems;
+    heap->resizable = config->resizable;
+    heap->last = 0; // INT64_MIN
+
+    if (0 != i_oha_rxh_init_heap(heap)) {
+        oha_free(&config->memory, heap);
+        return NULL;
+    }
+    return heap;
+}
+
+OHA_FORCE_INLINE void *
+oha_rxh_find_min_int(struct oha_rxh * const heap, int64_t * const key)
+{
+    assert(heap);
+    if (heap->elems == 0) {
+        return NULL;
+    }
+    if (heap->buckets[0] == NULL) {
+        i_oha_rxh_pull(heap);
+    }
+    struct oha_rxh_node * const node = heap->buckets[0];
+    if (key != NULL) {
+        *key = node->key;
+    }
+    return i_oha_rxh_get_value(node);
+}
+
+OHA_FORCE_INLINE void *
+oha_rxh_delete_min_int(struct oha_rxh * const heap)
+{
+    assert(heap);
+    if (heap->elems == 0) {
+        return NULL;
+    }
+    if (heap->buckets[0] == NULL) {
+        i_oha_rxh_pull(heap);
+    }
+    struct oha_rxh_node * const node = heap->buckets[0];
+    i_oha_rxh_unlink(heap, node);
+    i_oha_rxh_free_node(heap, node);
+    return i_oha_rxh_get_value(node);
+}
+
+OHA_FORCE_INLINE void *
+oha_rxh_insert_int(struct oha_rxh * const heap, const int64_t key)
+{
+    assert(heap);
+    if (heap->elems >= heap->max_elems) {
+        if (i_oha_rxh_grow(heap)) {
+            return NULL;
+        }
+    }
+
+    struct oha_rxh_node * const node = heap->free_nodes;
+    assert(node != NULL);
+    heap->free_nodes = node->next;
+    node->key = key;
+    i_oha_rxh_link(heap, node);
+    heap->elems++;
+    return i_oha_rxh_get_value(node);
+}
+
+OHA_FORCE_INLINE int64_t
+oha_rxh_get_key_int(const struct oha_rxh * const heap, const void * const value)
+{
+    assert(heap && value);
+    (void)heap;
+    const struct oha_rxh_node * const node = i_oha_rxh_get_node(value);
+    assert(node->bucket != OHA_RXH_FREE_NODE);
+    return node->key;
+}
+
+OHA_FORCE_INLINE int
+oha_rxh_change_key_int(struct oha_rxh * const heap, void * const value, const int64_t new_key)
+{
+    assert(heap && value);
+    struct oha_rxh_node * const node = i_oha_rxh_get_node(value);
+    if (node->bucket == OHA_RXH_FREE_NODE) {
+        return -1;
+    }
+    i_oha_rxh_unlink(heap, node);
+    node->key = new_key;
+    i_oha_rxh_link(heap, node);
+    return 0;
+}
+
+OHA_FORCE_INLINE int
+oha_rxh_remove_int(struct oha_rxh * const heap, void * const value)
+{
+    assert(heap && value);
+    struct oha_rxh_node * const node = i_oha_rxh_get_node(value);
+    if (node->bucket == OHA_RXH_FREE_NODE) {
+        return -1;
+    }
+    i_oha_rxh_unlink(heap, node);
+    i_oha_rxh_free_node(heap, node);
+    return 0;
+}
+
+OHA_FORCE_INLINE int
+oha_rxh_get_status_int(const struct oha_rxh * const heap, struct oha_bh_status * const status)
+{
+    assert(heap && status);
+
+    status->max_elems = heap->max_elems;
+    status->elems_in_use = heap->elems;
+    status->size_in_bytes =
+        // nodes with values
+        heap->node_size * heap->max_elems +
+        // buffer list of the value pool
+        sizeof(*heap->value_pool.buffers) * heap->value_pool.elems +
+        // heap offset size
+        sizeof(struct oha_rxh);
+    return 0;
+}
+
+/**********************************************************************************************************************
+ *
+ * public interface functions section
+ *
+ *********************************************************************************************************************/
+
+OHA_PUBLIC_API struct oha_rxh *
+oha_rxh_create(const struct oha_rxh_config * const config)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (config == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_rxh_create_int(config);
+}
+
+OHA_PUBLIC_API void
+oha_rxh_destroy(struct oha_rxh * const heap)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return;
+    }
+#endif
+    oha_rxh_destroy_int(heap);
+}
+
+OHA_PUBLIC_API void *
+oha_rxh_find_min(struct oha_rxh * const heap, int64_t * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_rxh_find_min_int(heap, key);
+}
+
+OHA_PUBLIC_API void *
+oha_rxh_delete_min(struct oha_rxh * const heap)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_rxh_delete_min_int(heap);
+}
+
+OHA_PUBLIC_API void *
+oha_rxh_insert(struct oha_rxh * const heap, const int64_t key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_rxh_insert_int(heap, key);
+}
+
+OHA_PUBLIC_API int64_t
+oha_rxh_get_key(const struct oha_rxh * const heap, const void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || value == NULL) {
+        return INT64_MAX;
+    }
+#endif
+    return oha_rxh_get_key_int(heap, value);
+}
+
+OHA_PUBLIC_API int
+oha_rxh_change_key(struct oha_rxh * const heap, void * const value, const int64_t new_key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || value == NULL) {
+        return -1;
+    }
+#endif
+    return oha_rxh_change_key_int(heap, value, new_key);
+}
+
+OHA_PUBLIC_API int
+oha_rxh_remove(struct oha_rxh * const heap, void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || value == NULL) {
+        return -1;
+    }
+#endif
+    return oha_rxh_remove_int(heap, value);
+}
+
+OHA_PUBLIC_API int
+oha_rxh_get_status(const struct oha_rxh * const heap, struct oha_bh_status * const status)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (heap == NULL || status == NULL) {
+        return -1;
+    }
+#endif
+    return oha_rxh_get_status_int(heap, status);
+}
+
+#endif
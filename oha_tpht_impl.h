@@ -0,0 +1,464 @@
+#ifndef OHA_TEMPORAL_PRIORITIZED_HASH_TABLE_H_
+#define OHA_TEMPORAL_PRIORITIZED_HASH_TABLE_H_
+
+#include "oha.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oha_utils.h"
+#include "oha_lpht_impl.h"
+#include "oha_bh_impl.h"
+#include "oha_rxh_impl.h"
+
+struct oha_tpht {
+    struct oha_lpht * table;
+    // heap of all deadlines, either a binary or a radix heap, the heap values are copies of the keys
+    struct oha_bh * deadlines;
+    struct oha_rxh * monotone_deadlines;
+    size_t deadline_ref_offset; // position of the heap value pointer behind the user value in the table value
+};
+
+// the table value keeps the heap value of its deadline, the heap value keeps the key of the table element
+OHA_FORCE_INLINE void **
+i_oha_tpht_deadline_ref(const struct oha_tpht * const table, void * const value)
+{
+    return (void **)oha_move_ptr_num_bytes(value, table->deadline_ref_offset);
+}
+
+OHA_FORCE_INLINE void *
+i_oha_tpht_deadlines_insert(struct oha_tpht * const table, const int64_t deadline)
+{
+    if (table->monotone_deadlines != NULL) {
+        return oha_rxh_insert_int(table->monotone_deadlines, deadline);
+    }
+    return oha_bh_insert_int(table->deadlines, deadline);
+}
+
+OHA_FORCE_INLINE int
+i_oha_tpht_deadlines_remove(struct oha_tpht * const table, void * const key_copy)
+{
+    if (table->monotone_deadlines != NULL) {
+        return oha_rxh_remove_int(table->monotone_deadlines, key_copy);
+    }
+    return oha_bh_remove_int(table->deadlines, key_copy);
+}
+
+OHA_FORCE_INLINE int
+i_oha_tpht_deadlines_change(struct oha_tpht * const table, void * const key_copy, const int64_t deadline)
+{
+    if (table->monotone_deadlines != NULL) {
+        return oha_rxh_change_key_int(table->monotone_deadlines, key_copy, deadline);
+    }
+    return oha_bh_change_key_int(table->deadlines, key_copy, deadline);
+}
+
+OHA_FORCE_INLINE int64_t
+i_oha_tpht_deadlines_get(const struct oha_tpht * const table, const void * const key_copy)
+{
+    if (table->monotone_deadlines != NULL) {
+        return oha_rxh_get_key_int(table->monotone_deadlines, key_copy);
+    }
+    return oha_bh_get_key_int(table->deadlines, key_copy);
+}
+
+OHA_FORCE_INLINE void *
+i_oha_tpht_deadlines_find_min(const struct oha_tpht * const table, int64_t * const deadline)
+{
+    if (table->monotone_deadlines != NULL) {
+        return oha_rxh_find_min_int(table->monotone_deadlines, deadline);
+    }
+    return oha_bh_find_min_int(table->deadlines, deadline);
+}
+
+OHA_FORCE_INLINE void
+i_oha_tpht_deadlines_delete_min(struct oha_tpht * const table)
+{
+    if (table->monotone_deadlines != NULL) {
+        (void)oha_rxh_delete_min_int(table->monotone_deadlines);
+    } else {
+        (void)oha_bh_delete_min_int(table->deadlines);
+    }
+}
+
+OHA_FORCE_INLINE void
+oha_tpht_destroy_int(struct oha_tpht * const table)
+{
+    assert(table);
+    const struct oha_memory_fp memory = table->table->memory;
+    oha_lpht_destroy_int(table->table);
+    if (table->deadlines != NULL) {
+        oha_bh_destroy_int(table->deadlines);
+    }
+    if (table->monotone_deadlines != NULL) {
+        oha_rxh_destroy_int(table->monotone_deadlines);
+    }
+    oha_free(&memory, table);
+}
+
+OHA_FORCE_INLINE struct oha_tpht *
+oha_tpht_create_int(const struct oha_tpht_config * const config)
+{
+    assert(config);
+    const struct oha_memory_fp * memory = &config->table_config.memory;
+
+    struct oha_tpht * const table = (struct oha_tpht *)oha_calloc(memory, sizeof(struct oha_tpht));
+    if (table == NULL) {
+        return NULL;
+    }
+
+    struct oha_lpht_config table_config = config->table_config;
+    table->deadline_ref_offset = OHA_ALIGN_UP(table_config.value_size);
+    table_config.value_size = table->deadline_ref_offset + sizeof(void *);
+    table->table = oha_lpht_create_int(&table_config);
+    if (table->table == NULL) {
+        oha_free(memory, table);
+        return NULL;
+    }
+
+    if (config->monotone_deadlines) {
+        struct oha_rxh_config heap_config;
+        memset(&heap_config, 0, sizeof(heap_config));
+        heap_config.memory = table_config.memory;
+        heap_config.value_size = table_config.key_size;
+        heap_config.max_elems = table_config.max_elems;
+        heap_config.resizable = table_config.resizable;
+        table->monotone_deadlines = oha_rxh_create_int(&heap_config);
+    } else {
+        struct oha_bh_config heap_config;
+        memset(&heap_config, 0, sizeof(heap_config));
+        heap_config.memory = table_config.memory;
+        heap_config.value_size = table_config.key_size;
+        heap_config.max_elems = table_config.max_elems;
+        heap_config.resizable = table_config.resizable;
+        heap_config.arity = config->heap_arity;
+        table->deadlines = oha_bh_create_int(&heap_config);
+    }
+    if (table->deadlines == NULL && table->monotone_deadlines == NULL) {
+        oha_tpht_destroy_int(table);
+        return NULL;
+    }
+    return table;
+}
+
+OHA_FORCE_INLINE void *
+oha_tpht_look_up_int(const struct oha_tpht * const table, const void * const key, const int64_t now)
+{
+    assert(table && key);
+    const struct oha_lpht_key_bucket * const bucket = oha_lpht_look_up_int(table->table, key);
+    if (bucket == NULL) {
+        return NULL;
+    }
+    void * const value = i_oha_lpht_get_value(table->table, bucket);
+    // lazy expiry, the element is released by the next oha_tpht_expire() call
+    if (i_oha_tpht_deadlines_get(table, *i_oha_tpht_deadline_ref(table, value)) <= now) {
+        return NULL;
+    }
+    return value;
+}
+
+OHA_FORCE_INLINE void *
+oha_tpht_insert_int(struct oha_tpht * const table,
+                    const void * const key,
+                    const int64_t deadline,
+                    const int64_t now,
+                    bool * const inserted)
+{
+    assert(table && key);
+    struct oha_lpht * const lpht = table->table;
+    bool is_new;
+    struct oha_lpht_key_bucket * const bucket =
+        i_oha_lpht_insert_hashed(lpht, key, i_oha_lpht_hash_key(lpht, key), &is_new);
+    if (inserted != NULL) {
+        *inserted = is_new;
+    }
+    if (bucket == NULL) {
+        return NULL;
+    }
+    void * const value = i_oha_lpht_get_value(lpht, bucket);
+    if (!is_new) {
+        void * const key_copy = *i_oha_tpht_deadline_ref(table, value);
+        if (i_oha_tpht_deadlines_get(table, key_copy) > now) {
+            return value;
+        }
+        // an expired element, which is not yet collected, is replaced by the new one
+        if (i_oha_tpht_deadlines_change(table, key_copy, deadline) != 0) {
+            return NULL;
+        }
+        if (inserted != NULL) {
+            *inserted = true;
+        }
+        return value;
+    }
+
+    void * const key_copy = i_oha_tpht_deadlines_insert(table, deadline);
+    if (key_copy == NULL) {
+        (void)oha_lpht_remove_int(lpht, key);
+        return NULL;
+    }
+    memcpy(key_copy, key, lpht->key_size);
+    *i_oha_tpht_deadline_ref(table, value) = key_copy;
+    return value;
+}
+
+OHA_FORCE_INLINE void *
+oha_tpht_remove_int(struct oha_tpht * const table, const void * const key)
+{
+    assert(table && key);
+    void * const value = oha_lpht_remove_int(table->table, key);
+    if (value == NULL) {
+        return NULL;
+    }
+    const int error = i_oha_tpht_deadlines_remove(table, *i_oha_tpht_deadline_ref(table, value));
+    assert(error == 0);
+    (void)error;
+    return value;
+}
+
+OHA_FORCE_INLINE int
+oha_tpht_set_deadline_int(struct oha_tpht * const table, void * const value, const int64_t deadline)
+{
+    assert(table && value);
+    return i_oha_tpht_deadlines_change(table, *i_oha_tpht_deadline_ref(table, value), deadline);
+}
+
+OHA_FORCE_INLINE int
+oha_tpht_reset_deadlines_int(struct oha_tpht * const table, const oha_tpht_deadline_fp callback, void * const ctx)
+{
+    assert(table && callback);
+    const struct oha_lpht * const lpht = table->table;
+    for (uint32_t i = i_oha_lpht_next_occupied(lpht, 0); i < lpht->max_indicies;
+         i = i_oha_lpht_next_occupied(lpht, i + 1)) {
+        const struct oha_lpht_key_bucket * const bucket = i_oha_lpht_get_bucket(lpht, i);
+        void * const value = i_oha_lpht_get_value(lpht, bucket);
+        const int64_t deadline = callback(bucket->key_buffer, value, ctx);
+        void * const key_copy = *i_oha_tpht_deadline_ref(table, value);
+        if (table->monotone_deadlines != NULL) {
+            // O(1) per element, no rebuild needed
+            (void)oha_rxh_change_key_int(table->monotone_deadlines, key_copy, deadline);
+        } else {
+            i_oha_bh_set_key_unordered(table->deadlines, key_copy, deadline);
+        }
+    }
+    if (table->deadlines != NULL) {
+        i_oha_bh_heapify(table->deadlines);
+    }
+    return 0;
+}
+
+OHA_FORCE_INLINE int64_t
+oha_tpht_get_deadline_int(const struct oha_tpht * const table, const void * const value)
+{
+    assert(table && value);
+    return i_oha_tpht_deadlines_get(table, *i_oha_tpht_deadline_ref(table, (void *)value));
+}
+
+// expires at most max_expired elements
+OHA_FORCE_INLINE uint32_t
+i_oha_tpht_expire(struct oha_tpht * const table,
+                  const int64_t now,
+                  const uint32_t max_expired,
+                  const oha_tpht_expired_fp callback,
+                  void * const ctx)
+{
+    uint32_t expired = 0;
+    if (table->deadlines != NULL) {
+        // the binary heap removes the due nodes batch wise, the key copies stay valid until the next heap insert
+        struct oha_bh_value_bucket * buckets[OHA_BH_BATCH_SIZE];
+        while (expired < max_expired) {
+            const uint32_t removed =
+                i_oha_bh_remove_due(table->deadlines, OMA_MIN(max_expired - expired, OHA_BH_BATCH_SIZE), now, buckets);
+            if (removed == 0) {
+                break;
+            }
+            for (uint32_t i = 0; i < removed; i++) {
+                const void * const key = i_oha_bh_get_value(buckets[i]);
+                void * const value = oha_lpht_remove_int(table->table, key);
+                assert(value != NULL);
+                if (callback != NULL) {
+                    callback(key, value, ctx);
+                }
+            }
+            expired += removed;
+        }
+        return expired;
+    }
+
+    int64_t deadline;
+    const void * key;
+    // only the due heap nodes are touched, the key copy stays valid until the next insert into the heap
+    while (expired < max_expired && (key = i_oha_tpht_deadlines_find_min(table, &deadline)) != NULL &&
+           deadline <= now) {
+        i_oha_tpht_deadlines_delete_min(table);
+        void * const value = oha_lpht_remove_int(table->table, key);
+        assert(value != NULL);
+        if (callback != NULL) {
+            callback(key, value, ctx);
+        }
+        expired++;
+    }
+    return expired;
+}
+
+OHA_FORCE_INLINE uint32_t
+oha_tpht_expire_int(struct oha_tpht * const table,
+                    const int64_t now,
+                    const oha_tpht_expired_fp callback,
+                    void * const ctx)
+{
+    assert(table);
+    return i_oha_tpht_expire(table, now, UINT32_MAX, callback, ctx);
+}
+
+OHA_FORCE_INLINE int
+oha_tpht_get_status_int(const struct oha_tpht * const table, struct oha_lpht_status * const status)
+{
+    assert(table && status);
+    struct oha_bh_status heap_status;
+    if (oha_lpht_get_status_int(table->table, status) != 0) {
+        return -1;
+    }
+    const int error = table->monotone_deadlines != NULL
+                          ? oha_rxh_get_status_int(table->monotone_deadlines, &heap_status)
+                          : oha_bh_get_status_int(table->deadlines, &heap_status);
+    if (error != 0) {
+        return -1;
+    }
+    status->size_in_bytes += heap_status.size_in_bytes + sizeof(struct oha_tpht);
+    return 0;
+}
+
+/**********************************************************************************************************************
+ *
+ * public interface functions section
+ *
+ *********************************************************************************************************************/
+
+OHA_PUBLIC_API struct oha_tpht *
+oha_tpht_create(const struct oha_tpht_config * const config)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (config == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_tpht_create_int(config);
+}
+
+OHA_PUBLIC_API void
+oha_tpht_destroy(struct oha_tpht * const table)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL) {
+        return;
+    }
+#endif
+    oha_tpht_destroy_int(table);
+}
+
+OHA_PUBLIC_API void *
+oha_tpht_look_up(const struct oha_tpht * const table, const void * const key, const int64_t now)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_tpht_look_up_int(table, key, now);
+}
+
+OHA_PUBLIC_API void *
+oha_tpht_insert(struct oha_tpht * const table,
+                const void * const key,
+                const int64_t deadline,
+                const int64_t now,
+                bool * const inserted)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_tpht_insert_int(table, key, deadline, now, inserted);
+}
+
+OHA_PUBLIC_API void *
+oha_tpht_remove(struct oha_tpht * const table, const void * const key)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || key == NULL) {
+        return NULL;
+    }
+#endif
+    return oha_tpht_remove_int(table, key);
+}
+
+OHA_PUBLIC_API int
+oha_tpht_set_deadline(struct oha_tpht * const table, void * const value, const int64_t deadline)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || value == NULL) {
+        return -1;
+    }
+#endif
+    return oha_tpht_set_deadline_int(table, value, deadline);
+}
+
+OHA_PUBLIC_API int
+oha_tpht_reset_deadlines(struct oha_tpht * const table, oha_tpht_deadline_fp callback, void * const ctx)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || callback == NULL) {
+        return -1;
+    }
+#endif
+    return oha_tpht_reset_deadlines_int(table, callback, ctx);
+}
+
+OHA_PUBLIC_API int64_t
+oha_tpht_get_deadline(const struct oha_tpht * const table, const void * const value)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || value == NULL) {
+        return INT64_MAX;
+    }
+#endif
+    return oha_tpht_get_deadline_int(table, value);
+}
+
+OHA_PUBLIC_API bool
+oha_tpht_next_deadline(const struct oha_tpht * const table, int64_t * const deadline)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || deadline == NULL) {
+        return false;
+    }
+#endif
+    return i_oha_tpht_deadlines_find_min(table, deadline) != NULL;
+}
+
+OHA_PUBLIC_API uint32_t
+oha_tpht_expire(struct oha_tpht * const table, const int64_t now, oha_tpht_expired_fp callback, void * const ctx)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL) {
+        return 0;
+    }
+#endif
+    return oha_tpht_expire_int(table, now, callback, ctx);
+}
+
+OHA_PUBLIC_API int
+oha_tpht_get_status(const struct oha_tpht * const table, struct oha_lpht_status * const status)
+{
+#if OHA_NULL_POINTER_CHECKS
+    if (table == NULL || status == NULL) {
+        return -1;
+    }
+#endif
+    return oha_tpht_get_status_int(table, status);
+}
+
+#endif
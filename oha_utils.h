@@ -19,11 +19,21 @@
 #define OHA_MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define OMA_MIN(x, y) (((x) < (y)) ? (x) : (y))
 
+#define OHA_PREFETCH(_addr) __builtin_prefetch(_addr)
+#define OHA_CTZ64(_word) ((uint32_t)__builtin_ctzll(_word))
+#define OHA_CLZ64(_word) ((uint32_t)__builtin_clzll(_word))
+
 #define OHA_ALIGN_UP(_num) (((_num) + ((SIZE_T_WIDTH)-1)) & ~((SIZE_T_WIDTH)-1))
 
+#ifdef __cplusplus
+#define OHA_STATIC_ASSERT static_assert
+#else
+#define OHA_STATIC_ASSERT _Static_assert
+#endif
+
 #define OHA_SWAP(x, y)                                                                                                 \
     do {                                                                                                               \
-        _Static_assert(sizeof(x) == sizeof(y), "swap of different types not supported");                               \
+        OHA_STATIC_ASSERT(sizeof(x) == sizeof(y), "swap of different types not supported");                            \
         unsigned char swap_temp[sizeof(x)];                                                                            \
         memcpy(swap_temp, &(y), sizeof(x));                                                                            \
         memcpy(&(y), &(x), sizeof(x));                                                                                 \
@@ -135,6 +145,21 @@ oha_next_power_of_two_32bit(uint32_t i)
     return i;
 }
 
+/*
+ * multiplicative inverse of an odd number modulo 2^64 by newton iteration, every step doubles the correct bits
+ * see: Hacker's Delight, chapter 10-16 "exact division by constants"
+ */
+OHA_FORCE_INLINE uint64_t
+oha_inverse_of_odd_64bit(const uint64_t odd)
+{
+    assert(odd % 2 == 1);
+    uint64_t inverse = odd; // correct for the lowest 3 bits
+    for (int i = 0; i < 5; i++) {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
 /*
  * fast compution of log2(x)
  * https://stackoverflow.com/questions/11376288/fast-computing-of-log2-for-64-bit-integers
@@ -156,7 +181,7 @@ oha_log2_32bit(uint32_t value)
 OHA_FORCE_INLINE uint32_t
 oha_lpht_hash_32bit(const void * buffer, const size_t len)
 {
-    const uint32_t * b = buffer;
+    const uint32_t * b = (const uint32_t *)buffer;
     uint32_t res = 2147483647; // magic prime
     uint32_t l = len >> 2;     // key must be at least 4 byte
     for (uint32_t i = 0; i < l; i++) {
@@ -195,7 +220,7 @@ oha_add_entry_to_array(const struct oha_memory_fp * const memory,
         *entry_count = 0;
     }
 
-    uint8_t * new_memory = oha_realloc(memory, *array, entry_size * ((*entry_count) + 1));
+    uint8_t * new_memory = (uint8_t *)oha_realloc(memory, *array, entry_size * ((*entry_count) + 1));
     if (new_memory != NULL) {
         (*entry_count)++;
         *array = new_memory;
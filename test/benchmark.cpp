@@ -29,21 +29,24 @@ enum command {
     REMOVE,
 };
 
+// record: operation (1 byte), key (key width bytes), optional time stamp (8 bytes, ignored)
+#define MAX_KEY_WIDTH sizeof(uint64_t)
+#define MAX_RECORD_SIZE (1 + MAX_KEY_WIDTH + sizeof(uint64_t))
+
 enum command
-get_cmd(char * line, size_t length, uint64_t & key)
+get_cmd(char * line, size_t length, size_t key_width, uint64_t & key)
 {
     if (length > 0) {
+        key = 0;
+        memcpy(&key, &line[1], key_width);
         switch (line[0]) {
             case '+':
-                key = *(uint32_t *)(&line[1]);
                 // std::cout << "+" << key << std::endl;
                 return INSERT;
             case '-':
-                key = *(uint32_t *)(&line[1]);
                 // std::cout << "-" << key << std::endl;
                 return REMOVE;
             case '?':
-                key = *(uint32_t *)(&line[1]);
                 // std::cout << "?" << key << std::endl;
                 return LOOKUP;
             default:
@@ -56,12 +59,16 @@ get_cmd(char * line, size_t length, uint64_t & key)
 int
 main(int argc, char * argv[])
 {
-    if (argc != 3) {
+    if (argc < 3 || argc > 5) {
         fprintf(stderr,
-                "missing parameters. Use [benchmark file] [mode]\n"
+                "missing parameters. Use [benchmark file] [mode] [key width] [time stamps]\n"
                 " mode:\n"
                 "   1: using lpth\n"
                 "   2: using c++ std::unordered_map<>\n"
+                "   5: using lpth with block backward shift removes\n"
+                "   6: using lpth with a bounded probe sequence length of 16\n"
+                " key width: number of key bytes per record, 1..8 (default 4)\n"
+                " time stamps: 1 if every record ends with a 64 bit time stamp, e.g. oha_lpht_trace_start() files\n"
                 " example: ./benchmark ../../test/benchmark.txt 1\n");
         return 1;
     }
@@ -69,7 +76,7 @@ main(int argc, char * argv[])
     ska_power_of_two * ska_power_of_tow = NULL;
     google_dense_hash * google_dense = NULL;
     struct oha_lpht * table = NULL;
-    char line_buf[5];
+    char line_buf[MAX_RECORD_SIZE];
     size_t line_buf_size = 0;
     int line_count = 0;
     ssize_t line_size;
@@ -81,8 +88,17 @@ main(int argc, char * argv[])
     }
 
     int mode = atoi(argv[2]);
+    const size_t key_width = argc > 3 ? atoi(argv[3]) : sizeof(uint32_t);
+    // recorded traces contain look up misses, generated benchmark files not
+    const bool trace = argc > 4 && atoi(argv[4]) == 1;
+    const size_t record_size = 1 + key_width + (trace ? sizeof(uint64_t) : 0);
+    if (key_width == 0 || key_width > MAX_KEY_WIDTH) {
+        fprintf(stderr, "unsupported key width %s\n", argv[3]);
+        fclose(fp);
+        return 1;
+    }
 
-    const struct oha_lpht_config config = {MAX_ELEMENTS, 0.5, sizeof(uint64_t), sizeof(struct value), {0}, false};
+    struct oha_lpht_config config = {MAX_ELEMENTS, 0.5, sizeof(uint64_t), sizeof(struct value), {0}, false};
 
     switch (mode) {
         case 1:
@@ -103,13 +119,25 @@ main(int argc, char * argv[])
             google_dense->set_empty_key(-1);
             google_dense->set_deleted_key(-2);
             break;
+        case 5:
+            printf("create linear polling hash table with block backward shift\n");
+            config.block_backward_shift = true;
+            table = oha_lpht_create(&config);
+            break;
+        case 6:
+            printf("create linear polling hash table with a bounded probe sequence length\n");
+            // a key outside of its probe window grows the table, instead of failing the insert
+            config.max_probe_length = 16;
+            config.resizable = true;
+            table = oha_lpht_create(&config);
+            break;
         default:
             fprintf(stderr, "unsupported mode %s\n", argv[2]);
             exit(1);
     }
 
     /* Get initial line */
-    line_size = fread(line_buf, 5, 1, fp);
+    line_size = fread(line_buf, record_size, 1, fp);
 
     uint64_t key;
     struct value * value;
@@ -119,7 +147,7 @@ main(int argc, char * argv[])
     while (line_size > 0) {
         line_count++;
 
-        enum command cmd = get_cmd(line_buf, line_size, key);
+        enum command cmd = get_cmd(line_buf, line_size, key_width, key);
         switch (cmd) {
             case INVALID:
                 fprintf(stderr, "invalid command in line %d \n", line_count);
@@ -131,7 +159,9 @@ main(int argc, char * argv[])
                 struct value tmp;
                 tmp.array[0] = key;
                 switch (mode) {
-                    case 1: {
+                    case 1:
+                    case 5:
+                    case 6: {
                         value = (struct value *)oha_lpht_insert(table, &key);
                         // crash if insert failed because of memory
                         memcpy(value, &tmp, sizeof(struct value));
@@ -157,28 +187,30 @@ main(int argc, char * argv[])
             case LOOKUP:
                 // printf("lookup: %lu\n", key);
                 switch (mode) {
-                    case 1: {
+                    case 1:
+                    case 5:
+                    case 6: {
                         value = (struct value *)oha_lpht_look_up(table, &key);
-                        if (value == NULL) {
+                        if (value == NULL && !trace) {
                             exit(1);
                         }
                         break;
                     }
                     case 2: {
                         unordered_map<uint64_t, struct value>::const_iterator got = umap->find(key);
-                        if (got == umap->end()) {
+                        if (got == umap->end() && !trace) {
                             exit(2);
                         }
                         break;
                     }
                     case 3: {
-                        if (ska_power_of_tow->find(key) == ska_power_of_tow->end()) {
+                        if (ska_power_of_tow->find(key) == ska_power_of_tow->end() && !trace) {
                             exit(3);
                         }
                         break;
                     }
                     case 4: {
-                        if (google_dense->find(key) == google_dense->end()) {
+                        if (google_dense->find(key) == google_dense->end() && !trace) {
                             exit(3);
                         }
                         break;
@@ -190,6 +222,8 @@ main(int argc, char * argv[])
                 // printf("remove: %lu\n", key);
                 switch (mode) {
                     case 1:
+                    case 5:
+                    case 6:
                         value = (struct value *)oha_lpht_remove(table, &key);
                         break;
                     case 2:
@@ -206,7 +240,7 @@ main(int argc, char * argv[])
                 break;
         }
         /* Get the next item */
-        line_size = fread(line_buf, 5, 1, fp);
+        line_size = fread(line_buf, record_size, 1, fp);
     }
 
     printf("test:\n -inserts:\t%lu\n -look ups:\t%lu\n -removes:\t%lu\n", inserts, lookups, removes);
@@ -0,0 +1,3 @@
+#include "../oha.h"
+
+#include "bh_tests.h"
@@ -0,0 +1,227 @@
+#include "tests_common.h"
+
+static int64_t
+scattered_key(uint64_t i)
+{
+    return (int64_t)((i * 2654435761U) % 1000003) - 500000;
+}
+
+void
+test_bh_create_destroy()
+{
+    struct oha_bh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(uint64_t);
+    TEST_ASSERT_NULL(oha_bh_create(&config));
+
+    // unsupported arities
+    config.max_elems = 100;
+    config.arity = 3;
+    TEST_ASSERT_NULL(oha_bh_create(&config));
+    config.arity = 16;
+    TEST_ASSERT_NULL(oha_bh_create(&config));
+
+    config.arity = 0;
+    struct oha_bh * heap = oha_bh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_NULL(oha_bh_find_min(heap, NULL));
+    TEST_ASSERT_NULL(oha_bh_delete_min(heap));
+
+    struct oha_bh_status status;
+    TEST_ASSERT_EQUAL(0, oha_bh_get_status(heap, &status));
+    TEST_ASSERT_EQUAL(100, status.max_elems);
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+    TEST_ASSERT_GREATER_THAN(100 * sizeof(uint64_t), status.size_in_bytes);
+    oha_bh_destroy(heap);
+}
+
+static void
+sort(uint8_t arity)
+{
+    const uint32_t num_elems = 10000;
+    struct oha_bh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    config.max_elems = num_elems;
+    config.arity = arity;
+    struct oha_bh * heap = oha_bh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    for (uint64_t i = 0; i < num_elems; i++) {
+        int64_t * value = oha_bh_insert(heap, scattered_key(i));
+        TEST_ASSERT_NOT_NULL(value);
+        *value = scattered_key(i);
+    }
+    // full fixed size heap
+    TEST_ASSERT_NULL(oha_bh_insert(heap, 0));
+
+    int64_t last = INT64_MIN;
+    for (uint64_t i = 0; i < num_elems; i++) {
+        int64_t key;
+        int64_t * value = oha_bh_find_min(heap, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_INT64(key, *value);
+        TEST_ASSERT_EQUAL_PTR(value, oha_bh_delete_min(heap));
+        TEST_ASSERT_TRUE(last <= key);
+        last = key;
+    }
+    TEST_ASSERT_NULL(oha_bh_delete_min(heap));
+    oha_bh_destroy(heap);
+}
+
+static void
+change_key_remove(uint8_t arity)
+{
+    const uint32_t num_elems = 5000;
+    struct oha_bh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    config.max_elems = 16;
+    config.resizable = true;
+    config.arity = arity;
+    struct oha_bh * heap = oha_bh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    int64_t ** values = calloc(num_elems, sizeof(int64_t *));
+    TEST_ASSERT_NOT_NULL(values);
+    for (uint64_t i = 0; i < num_elems; i++) {
+        values[i] = oha_bh_insert(heap, (int64_t)i);
+        TEST_ASSERT_NOT_NULL(values[i]);
+        *values[i] = (int64_t)i;
+    }
+    // values are not moved by resizes
+    for (uint64_t i = 0; i < num_elems; i++) {
+        TEST_ASSERT_EQUAL_INT64((int64_t)i, *values[i]);
+        TEST_ASSERT_EQUAL_INT64((int64_t)i, oha_bh_get_key(heap, values[i]));
+    }
+
+    // increase and decrease keys, the value keeps the new key
+    for (uint64_t i = 0; i < num_elems; i++) {
+        *values[i] = scattered_key(i);
+        TEST_ASSERT_EQUAL(0, oha_bh_change_key(heap, values[i], *values[i]));
+        TEST_ASSERT_EQUAL_INT64(*values[i], oha_bh_get_key(heap, values[i]));
+    }
+    uint32_t removed = 0;
+    for (uint64_t i = 0; i < num_elems; i += 3) {
+        TEST_ASSERT_EQUAL(0, oha_bh_remove(heap, values[i]));
+        // already removed
+        TEST_ASSERT_EQUAL(-1, oha_bh_remove(heap, values[i]));
+        TEST_ASSERT_EQUAL(-1, oha_bh_change_key(heap, values[i], 0));
+        removed++;
+    }
+
+    struct oha_bh_status status;
+    TEST_ASSERT_EQUAL(0, oha_bh_get_status(heap, &status));
+    TEST_ASSERT_EQUAL(num_elems - removed, status.elems_in_use);
+
+    int64_t last = INT64_MIN;
+    int64_t key;
+    int64_t * value;
+    while ((value = oha_bh_find_min(heap, &key)) != NULL) {
+        TEST_ASSERT_EQUAL_INT64(key, *value);
+        TEST_ASSERT_TRUE(last <= key);
+        last = key;
+        oha_bh_delete_min(heap);
+        removed++;
+    }
+    TEST_ASSERT_EQUAL(num_elems, removed);
+
+    free(values);
+    oha_bh_destroy(heap);
+}
+
+static void
+batch(uint8_t arity)
+{
+    const uint32_t num_keys = 4000;
+    struct oha_bh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    config.max_elems = 10;
+    config.resizable = true;
+    config.arity = arity;
+    struct oha_bh * heap = oha_bh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    int64_t * keys = calloc(num_keys, sizeof(int64_t));
+    void ** values = calloc(num_keys, sizeof(void *));
+    TEST_ASSERT_NOT_NULL(keys);
+    TEST_ASSERT_NOT_NULL(values);
+    for (uint64_t i = 0; i < num_keys; i++) {
+        keys[i] = scattered_key(i);
+    }
+
+    // the first batch rebuilds the heap, the smaller second batch is sifted up
+    const uint32_t first = num_keys - num_keys / 8;
+    TEST_ASSERT_EQUAL(0, oha_bh_insert_batch(heap, keys, first, values));
+    TEST_ASSERT_EQUAL(0, oha_bh_insert_batch(heap, keys + first, num_keys - first, values + first));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        *(int64_t *)values[i] = keys[i];
+        TEST_ASSERT_EQUAL_INT64(keys[i], oha_bh_get_key(heap, values[i]));
+    }
+
+    // fixed size heaps insert all or nothing
+    struct oha_bh_status status;
+    config.max_elems = 100;
+    config.resizable = false;
+    struct oha_bh * fixed = oha_bh_create(&config);
+    TEST_ASSERT_NOT_NULL(fixed);
+    TEST_ASSERT_EQUAL(-1, oha_bh_insert_batch(fixed, keys, 101, values));
+    TEST_ASSERT_EQUAL(0, oha_bh_get_status(fixed, &status));
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+    oha_bh_destroy(fixed);
+
+    int64_t last = INT64_MIN;
+    uint32_t deleted = 0;
+    size_t num;
+    while ((num = oha_bh_delete_min_batch(heap, 333, keys, values)) > 0) {
+        for (size_t i = 0; i < num; i++) {
+            TEST_ASSERT_EQUAL_INT64(keys[i], *(int64_t *)values[i]);
+            TEST_ASSERT_TRUE(last <= keys[i]);
+            last = keys[i];
+        }
+        deleted += num;
+    }
+    TEST_ASSERT_EQUAL(num_keys, deleted);
+    TEST_ASSERT_EQUAL(0, oha_bh_get_status(heap, &status));
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+
+    free(values);
+    free(keys);
+    oha_bh_destroy(heap);
+}
+
+void
+test_bh_sort()
+{
+    sort(2);
+    sort(4);
+    sort(8);
+}
+
+void
+test_bh_change_key_remove()
+{
+    change_key_remove(2);
+    change_key_remove(4);
+    change_key_remove(8);
+}
+
+void
+test_bh_batch()
+{
+    batch(2);
+    batch(4);
+    batch(8);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bh_create_destroy);
+    RUN_TEST(test_bh_sort);
+    RUN_TEST(test_bh_change_key_remove);
+    RUN_TEST(test_bh_batch);
+    return UNITY_END();
+}
@@ -0,0 +1,3 @@
+#include "../oha.h"
+
+#include "cache_tests.h"
@@ -0,0 +1,172 @@
+#include "tests_common.h"
+
+struct evicted_ctx {
+    uint32_t calls;
+    uint64_t last_key;
+};
+
+static void
+count_evicted(const void * key, void * value, void * ctx)
+{
+    struct evicted_ctx * evicted = ctx;
+    evicted->last_key = *(const uint64_t *)key;
+    TEST_ASSERT_EQUAL_UINT64(evicted->last_key, *(uint64_t *)value);
+    evicted->calls++;
+}
+
+static uint64_t *
+insert(struct oha_cache * cache, uint64_t key)
+{
+    uint64_t * value = oha_cache_insert(cache, &key);
+    TEST_ASSERT_NOT_NULL(value);
+    *value = key;
+    return value;
+}
+
+void
+test_cache_bounded()
+{
+    const uint32_t max_elems = 1000;
+    struct evicted_ctx ctx = {0, 0};
+    struct oha_cache_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(max_elems, 0.9, true); // resizable is ignored
+    config.evicted = count_evicted;
+    config.evicted_ctx = &ctx;
+    struct oha_cache * cache = oha_cache_create(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    for (uint64_t i = 0; i < 10 * max_elems; i++) {
+        insert(cache, i * 2654435761U);
+    }
+
+    struct oha_cache_status status;
+    TEST_ASSERT_EQUAL(0, oha_cache_get_status(cache, &status));
+    TEST_ASSERT_EQUAL(max_elems, status.max_elems);
+    TEST_ASSERT_EQUAL(max_elems, status.elems_in_use);
+    TEST_ASSERT_EQUAL(9 * max_elems, status.evictions);
+    TEST_ASSERT_EQUAL(9 * max_elems, ctx.calls);
+
+    // an already inserted key does not evict
+    uint64_t key = (uint64_t)(10 * max_elems - 1) * 2654435761U;
+    uint64_t * value = oha_cache_look_up(cache, &key);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_PTR(value, oha_cache_insert(cache, &key));
+    TEST_ASSERT_EQUAL(9 * max_elems, ctx.calls);
+
+    // a removed element frees its place
+    TEST_ASSERT_EQUAL_PTR(value, oha_cache_remove(cache, &key));
+    TEST_ASSERT_NULL(oha_cache_remove(cache, &key));
+    insert(cache, key);
+    TEST_ASSERT_EQUAL(9 * max_elems, ctx.calls);
+
+    oha_cache_destroy(cache);
+}
+
+void
+test_cache_second_chance()
+{
+    const uint32_t max_elems = 100;
+    struct evicted_ctx ctx = {0, 0};
+    struct oha_cache_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(max_elems, 0.9, true); // resizable is ignored
+    config.evicted = count_evicted;
+    config.evicted_ctx = &ctx;
+    struct oha_cache * cache = oha_cache_create(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    for (uint64_t i = 0; i < max_elems; i++) {
+        insert(cache, i);
+    }
+    // the hot keys are looked up before each insert of a new key
+    for (uint64_t i = max_elems; i < 20 * max_elems; i++) {
+        for (uint64_t hot = 0; hot < 10; hot++) {
+            TEST_ASSERT_NOT_NULL(oha_cache_look_up(cache, &hot));
+        }
+        insert(cache, i);
+        TEST_ASSERT_TRUE(ctx.last_key >= 10);
+    }
+    for (uint64_t hot = 0; hot < 10; hot++) {
+        uint64_t * value = oha_cache_look_up(cache, &hot);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(hot, *value);
+    }
+    uint64_t key = 10;
+    TEST_ASSERT_NULL(oha_cache_look_up(cache, &key));
+
+    struct oha_cache_status status;
+    TEST_ASSERT_EQUAL(0, oha_cache_get_status(cache, &status));
+    TEST_ASSERT_EQUAL(10 * 19 * max_elems + 10, status.hits);
+    TEST_ASSERT_EQUAL(1, status.misses);
+    TEST_ASSERT_EQUAL(19 * max_elems, status.evictions);
+
+    oha_cache_destroy(cache);
+}
+
+// all keys have the same hash, their 32 bit words sum up to the same value
+static uint64_t
+colliding_key(uint64_t i)
+{
+    return (i << 32) | (1000 - i);
+}
+
+void
+test_cache_max_probe_length()
+{
+    const uint32_t max_elems = 10;
+    struct evicted_ctx ctx = {0, 0};
+    struct oha_cache_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(max_elems, 0.5, false);
+    config.table_config.max_probe_length = 3;
+    config.evicted = count_evicted;
+    config.evicted_ctx = &ctx;
+    struct oha_cache * cache = oha_cache_create(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    // four colliding keys fill the probe window of their start bucket, the other keys start behind it
+    for (uint64_t i = 0; i < 4; i++) {
+        insert(cache, colliding_key(i));
+    }
+    for (uint64_t i = 4; i < max_elems; i++) {
+        insert(cache, 1010 + i);
+    }
+    // the colliding keys are referenced, so the clock hand would evict one of the other keys
+    for (uint64_t i = 0; i < 4; i++) {
+        uint64_t key = colliding_key(i);
+        TEST_ASSERT_NOT_NULL(oha_cache_look_up(cache, &key));
+    }
+
+    // the fifth colliding key does not fit and evicts nothing
+    uint64_t key = colliding_key(4);
+    TEST_ASSERT_NULL(oha_cache_insert(cache, &key));
+    TEST_ASSERT_EQUAL(0, ctx.calls);
+    struct oha_cache_status status;
+    TEST_ASSERT_EQUAL(0, oha_cache_get_status(cache, &status));
+    TEST_ASSERT_EQUAL(max_elems, status.elems_in_use);
+    TEST_ASSERT_EQUAL(0, status.evictions);
+    for (uint64_t i = 4; i < max_elems; i++) {
+        key = 1010 + i;
+        TEST_ASSERT_NOT_NULL(oha_cache_look_up(cache, &key));
+    }
+
+    // a key which fits evicts one element
+    insert(cache, 2000);
+    TEST_ASSERT_EQUAL(1, ctx.calls);
+    TEST_ASSERT_EQUAL(0, oha_cache_get_status(cache, &status));
+    TEST_ASSERT_EQUAL(max_elems, status.elems_in_use);
+    TEST_ASSERT_EQUAL(1, status.evictions);
+
+    oha_cache_destroy(cache);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cache_bounded);
+    RUN_TEST(test_cache_second_chance);
+    RUN_TEST(test_cache_max_probe_length);
+    return UNITY_END();
+}
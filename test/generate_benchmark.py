@@ -4,7 +4,7 @@ import argparse
 import random
 
 
-def gererate_benchmark_output(num_operations, range_max, max_num_equal, file_name):
+def gererate_benchmark_output(num_operations, range_max, max_num_equal, key_width, file_name):
     randon_nums = dict()
 
     with open(file_name, 'wb') as file:
@@ -15,15 +15,15 @@ def gererate_benchmark_output(num_operations, range_max, max_num_equal, file_nam
             if value is None:
                 randon_nums[irand] = 1
                 file.write(str.encode('+'))
-                file.write((irand).to_bytes(4, byteorder='little', signed=False))
+                file.write((irand).to_bytes(key_width, byteorder='little', signed=False))
             elif value == max_num_equal:
                 randon_nums.pop(irand)
                 file.write(str.encode('-'))
-                file.write((irand).to_bytes(4, byteorder='little', signed=False))
+                file.write((irand).to_bytes(key_width, byteorder='little', signed=False))
             else:
                 randon_nums[irand] = value + 1
                 file.write(str.encode('?'))
-                file.write((irand).to_bytes(4, byteorder='little', signed=False))
+                file.write((irand).to_bytes(key_width, byteorder='little', signed=False))
 
 
 def setup_arg_parser():
@@ -53,6 +53,13 @@ def setup_arg_parser():
         default=30,
         help='after this number of look ups for a specific key is reached, this key will be removed.'
     )
+    parser.add_argument(
+        '--key-width',
+        type=int,
+        nargs='?',
+        default=4,
+        help='number of bytes of every key in the file, use the same value as benchmark parameter.'
+    )
     parser.add_argument('--file', type=str, nargs='?', default="benchmark.out",)
 
     return parser.parse_args()
@@ -60,7 +67,8 @@ def setup_arg_parser():
 
 def main():
     args = setup_arg_parser()
-    gererate_benchmark_output(args.num_operation, args.key_max, args.max_lookups_per_key, args.file)
+    gererate_benchmark_output(args.num_operation, args.key_max, args.max_lookups_per_key, args.key_width,
+                              args.file)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,3 @@
+#include "../oha.h"
+
+#include "htw_tests.h"
@@ -0,0 +1,142 @@
+#include "tests_common.h"
+
+struct expired_ctx {
+    struct oha_htw * wheel;
+    uint64_t previous_now; // timers must not expire before the advance which passes their expiry
+    uint64_t now;
+    uint32_t calls;
+};
+
+// the value of each timer is its expiry
+static void
+check_expired(const void * key, void * value, void * ctx)
+{
+    struct expired_ctx * expired = ctx;
+    const uint64_t expires = *(uint64_t *)value;
+    TEST_ASSERT_TRUE(expires <= expired->now);
+    TEST_ASSERT_TRUE(expires > expired->previous_now);
+    TEST_ASSERT_EQUAL_UINT64(expires, oha_htw_get_expiry(expired->wheel, value));
+    (void)key;
+    expired->calls++;
+}
+
+static uint32_t
+advance(struct expired_ctx * ctx, uint64_t now)
+{
+    ctx->now = now;
+    const uint32_t expired = oha_htw_advance(ctx->wheel, now, check_expired, ctx);
+    ctx->previous_now = now;
+    return expired;
+}
+
+static void
+start(struct oha_htw * wheel, uint64_t key, uint64_t expires)
+{
+    uint64_t * value = oha_htw_start(wheel, &key, expires);
+    TEST_ASSERT_NOT_NULL(value);
+    *value = expires;
+}
+
+void
+test_htw_expire_in_order()
+{
+    const uint64_t num_timers = 20000;
+    const uint64_t start_time = 1000;
+    struct oha_htw_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(64, 0.8, true);
+    config.now = start_time;
+    struct expired_ctx ctx = {oha_htw_create(&config), start_time, start_time, 0};
+    TEST_ASSERT_NOT_NULL(ctx.wheel);
+
+    // expiries from the next tick up to behind the last level of the wheel
+    uint64_t range = 1;
+    for (uint64_t i = 0; i < num_timers; i++) {
+        start(ctx.wheel, i, start_time + 1 + (i * 2654435761U) % range);
+        range = range < (UINT64_C(1) << 40) ? range * 3 : 1;
+    }
+
+    uint64_t now = start_time;
+    uint64_t step = 1;
+    uint32_t expired = 0;
+    while (expired < num_timers) {
+        now += step;
+        step = step * 7 % (UINT64_C(1) << 38) + 1;
+        expired += advance(&ctx, now);
+    }
+    TEST_ASSERT_EQUAL(num_timers, expired);
+    TEST_ASSERT_EQUAL(num_timers, ctx.calls);
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_EQUAL(0, oha_htw_get_status(ctx.wheel, &status));
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+    oha_htw_destroy(ctx.wheel);
+}
+
+void
+test_htw_every_tick()
+{
+    const uint64_t num_timers = 5000;
+    struct oha_htw_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(64, 0.8, true);
+    struct expired_ctx ctx = {oha_htw_create(&config), 0, 0, 0};
+    TEST_ASSERT_NOT_NULL(ctx.wheel);
+
+    for (uint64_t i = 0; i < num_timers; i++) {
+        start(ctx.wheel, i, i + 1);
+    }
+    for (uint64_t now = 1; now <= num_timers; now++) {
+        TEST_ASSERT_EQUAL(1, advance(&ctx, now));
+    }
+    TEST_ASSERT_EQUAL(0, advance(&ctx, UINT64_C(1) << 50));
+    oha_htw_destroy(ctx.wheel);
+}
+
+void
+test_htw_restart_stop()
+{
+    const uint64_t num_timers = 1000;
+    struct oha_htw_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(64, 0.8, true);
+    struct expired_ctx ctx = {oha_htw_create(&config), 0, 0, 0};
+    TEST_ASSERT_NOT_NULL(ctx.wheel);
+
+    for (uint64_t i = 0; i < num_timers; i++) {
+        start(ctx.wheel, i, 100 + i);
+    }
+    // restart the odd timers later and stop every fourth timer
+    for (uint64_t i = 0; i < num_timers; i++) {
+        if (i % 2 == 1) {
+            start(ctx.wheel, i, 5000 + i);
+        } else if (i % 4 == 0) {
+            uint64_t * value = oha_htw_look_up(ctx.wheel, &i);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_PTR(value, oha_htw_stop(ctx.wheel, &i));
+            TEST_ASSERT_NULL(oha_htw_stop(ctx.wheel, &i));
+            TEST_ASSERT_NULL(oha_htw_look_up(ctx.wheel, &i));
+        }
+    }
+    TEST_ASSERT_EQUAL(num_timers / 4, advance(&ctx, 4999));
+    for (uint64_t i = 0; i < num_timers; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, oha_htw_look_up(ctx.wheel, &i) != NULL);
+    }
+
+    // timers in the past expire with the next advance
+    start(ctx.wheel, num_timers, 10);
+    TEST_ASSERT_EQUAL(0, oha_htw_advance(ctx.wheel, 4999, NULL, NULL));
+    TEST_ASSERT_EQUAL(1, oha_htw_advance(ctx.wheel, 5000, NULL, NULL));
+    TEST_ASSERT_EQUAL(num_timers / 2, advance(&ctx, 6000));
+    oha_htw_destroy(ctx.wheel);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_htw_expire_in_order);
+    RUN_TEST(test_htw_every_tick);
+    RUN_TEST(test_htw_restart_stop);
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+#define OHA_WITH_TRACE_SUPPORT
+#include "../oha.hpp"
+#include <unity.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#define TRACE_FILE "lpht_cpp_tests_trace.bin"
+
+/* Is run before every test, put unit init calls here. */
+void
+setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void
+tearDown(void)
+{
+    std::remove(TRACE_FILE);
+}
+
+static uint64_t
+scattered_key(uint64_t i)
+{
+    return i * 2654435761U;
+}
+
+void
+test_emplace_find_erase(void)
+{
+    const uint64_t num_keys = 10000;
+    oha::lpht<uint64_t, std::string> table;
+    TEST_ASSERT_TRUE(table.empty());
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        auto res = table.emplace(scattered_key(i), std::to_string(i));
+        TEST_ASSERT_TRUE(res.second);
+        TEST_ASSERT_EQUAL_UINT64(scattered_key(i), res.first.key());
+    }
+    TEST_ASSERT_EQUAL(num_keys, table.size());
+
+    // duplicates keep the first value
+    auto res = table.emplace(scattered_key(1), "duplicate");
+    TEST_ASSERT_FALSE(res.second);
+    TEST_ASSERT_EQUAL_STRING("1", res.first->second.c_str());
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        auto it = table.find(scattered_key(i));
+        TEST_ASSERT_TRUE(it != table.end());
+        TEST_ASSERT_EQUAL_STRING(std::to_string(i).c_str(), (*it).second.c_str());
+    }
+    TEST_ASSERT_TRUE(table.find(scattered_key(num_keys)) == table.end());
+    TEST_ASSERT_FALSE(table.contains(scattered_key(num_keys)));
+
+    for (uint64_t i = 0; i < num_keys; i += 2) {
+        TEST_ASSERT_EQUAL(1, table.erase(scattered_key(i)));
+        TEST_ASSERT_EQUAL(0, table.erase(scattered_key(i)));
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, table.contains(scattered_key(i)));
+    }
+
+    table[scattered_key(num_keys)] = "operator[]";
+    TEST_ASSERT_EQUAL_STRING("operator[]", table[scattered_key(num_keys)].c_str());
+}
+
+void
+test_move_only_values(void)
+{
+    oha::lpht<uint32_t, std::unique_ptr<uint32_t>> table;
+
+    for (uint32_t i = 0; i < 1000; i++) {
+        std::unique_ptr<uint32_t> value(new uint32_t(i));
+        TEST_ASSERT_TRUE(table.emplace(i, std::move(value)).second);
+        TEST_ASSERT_NULL(value.get());
+    }
+
+    // values are never moved by the table, also not by resizes
+    uint32_t * first = table.find(0)->second.get();
+    std::unique_ptr<uint32_t> * first_value = &table.find(0).value();
+    for (uint32_t i = 1000; i < 10000; i++) {
+        table.emplace(i, new uint32_t(i));
+    }
+    TEST_ASSERT_EQUAL_PTR(first_value, &table.find(0).value());
+    TEST_ASSERT_EQUAL_PTR(first, table.find(0)->second.get());
+
+    // moved tables keep all elements
+    oha::lpht<uint32_t, std::unique_ptr<uint32_t>> moved(std::move(table));
+    TEST_ASSERT_EQUAL(10000, moved.size());
+    TEST_ASSERT_EQUAL_UINT32(42, *moved.find(42)->second);
+}
+
+void
+test_small_keys(void)
+{
+    oha::lpht<uint8_t, int> table;
+
+    for (int i = 0; i < 256; i++) {
+        table[(uint8_t)i] = i;
+    }
+    TEST_ASSERT_EQUAL(256, table.size());
+
+    int sum = 0;
+    for (auto kv : table) {
+        TEST_ASSERT_EQUAL(kv.first, kv.second);
+        sum += kv.second;
+    }
+    TEST_ASSERT_EQUAL(255 * 256 / 2, sum);
+}
+
+struct counted {
+    static int alive;
+    uint64_t value;
+
+    explicit counted(uint64_t v) : value(v)
+    {
+        alive++;
+    }
+    ~counted()
+    {
+        alive--;
+    }
+    counted(const counted &) = delete;
+};
+int counted::alive = 0;
+
+void
+test_iterate_erase_if_clear(void)
+{
+    const uint64_t num_keys = 5000;
+    {
+        oha::lpht<uint64_t, counted> table;
+        for (uint64_t i = 0; i < num_keys; i++) {
+            table.emplace(scattered_key(i), i);
+        }
+        TEST_ASSERT_EQUAL(num_keys, counted::alive);
+
+        uint64_t visited = 0;
+        const oha::lpht<uint64_t, counted> & const_table = table;
+        for (auto it = const_table.begin(); it != const_table.end(); ++it) {
+            TEST_ASSERT_EQUAL_UINT64(scattered_key(it.value().value), it.key());
+            visited++;
+        }
+        TEST_ASSERT_EQUAL(num_keys, visited);
+
+        const size_t erased = table.erase_if([](uint64_t, const counted & c) { return c.value % 3 == 0; });
+        TEST_ASSERT_EQUAL((num_keys + 2) / 3, erased);
+        TEST_ASSERT_EQUAL(num_keys - erased, counted::alive);
+        TEST_ASSERT_EQUAL(num_keys - erased, table.size());
+
+        table.clear();
+        TEST_ASSERT_EQUAL(0, counted::alive);
+        TEST_ASSERT_TRUE(table.begin() == table.end());
+
+        for (uint64_t i = 0; i < 100; i++) {
+            table.emplace(i, i);
+        }
+    }
+    // destructor releases the remaining values
+    TEST_ASSERT_EQUAL(0, counted::alive);
+}
+
+void
+test_fixed_size_table(void)
+{
+    struct oha_lpht_config config = oha::lpht<uint64_t, uint64_t>::default_config();
+    config.max_elems = 10;
+    config.resizable = false;
+    oha::lpht<uint64_t, uint64_t> table(config);
+
+    for (uint64_t i = 0; i < 10; i++) {
+        table[i] = i;
+    }
+    bool thrown = false;
+    try {
+        table[10] = 10;
+    } catch (const std::bad_alloc &) {
+        thrown = true;
+    }
+    TEST_ASSERT_TRUE(thrown);
+    TEST_ASSERT_FALSE(table.reserve(100));
+
+    // the native table is shared with the C interface
+    uint64_t key = 5;
+    TEST_ASSERT_EQUAL_PTR(&table[5], oha_lpht_look_up(table.native(), &key));
+}
+
+void
+test_trace(void)
+{
+    oha::lpht<uint32_t, uint32_t> table;
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_start(table.native(), TRACE_FILE, 2));
+    table[7] = 1;
+    TEST_ASSERT_TRUE(table.contains(7));
+    TEST_ASSERT_TRUE(table.find(8) == table.end());
+    TEST_ASSERT_EQUAL(1, table.erase(7));
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_stop(table.native()));
+
+    // the wrapper records the same operations as the C interface
+    const char operations[] = {'+', '?', '?', '-'};
+    const uint32_t keys[] = {7, 7, 8, 7};
+    std::FILE * fp = std::fopen(TRACE_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    for (size_t i = 0; i < sizeof(operations); i++) {
+        unsigned char record[1 + sizeof(uint32_t) + sizeof(uint64_t)];
+        TEST_ASSERT_EQUAL(1, std::fread(record, sizeof(record), 1, fp));
+        TEST_ASSERT_EQUAL_CHAR(operations[i], record[0]);
+        uint32_t key;
+        std::memcpy(&key, record + 1, sizeof(key));
+        TEST_ASSERT_EQUAL_UINT32(keys[i], key);
+    }
+    unsigned char end;
+    TEST_ASSERT_EQUAL(0, std::fread(&end, 1, 1, fp));
+    std::fclose(fp);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_emplace_find_erase);
+    RUN_TEST(test_move_only_values);
+    RUN_TEST(test_small_keys);
+    RUN_TEST(test_iterate_erase_if_clear);
+    RUN_TEST(test_fixed_size_table);
+    RUN_TEST(test_trace);
+    return UNITY_END();
+}
@@ -379,6 +379,1365 @@ test_insert_with_resize()
     oha_lpht_destroy(table);
 }
 
+void
+test_insert_batch()
+{
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    // every key twice, the second one is already inserted
+    enum { num_keys = 100 };
+    uint64_t keys[2 * num_keys];
+    void * values[2 * num_keys];
+    bool inserted[2 * num_keys];
+    for (uint64_t i = 0; i < num_keys; i++) {
+        keys[i] = i;
+        keys[num_keys + i] = i;
+    }
+
+    TEST_ASSERT_EQUAL(0, oha_lpht_insert_batch(table, keys, 2 * num_keys, values, inserted));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_TRUE(inserted[i]);
+        TEST_ASSERT_FALSE(inserted[num_keys + i]);
+        TEST_ASSERT_NOT_NULL(values[i]);
+        TEST_ASSERT_EQUAL_PTR(values[i], values[num_keys + i]);
+        TEST_ASSERT_EQUAL_PTR(values[i], oha_lpht_look_up(table, &i));
+        *(uint64_t *)values[i] = i;
+    }
+
+    struct oha_lpht_status status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT64(num_keys, status.elems_in_use);
+
+    // values are kept by a second batch, inserted flags are optional
+    TEST_ASSERT_EQUAL(0, oha_lpht_insert_batch(table, keys, num_keys, values, NULL));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)values[i]);
+    }
+    oha_lpht_destroy(table);
+
+    // fixed size table can not take all keys
+    config.max_elems = num_keys / 2;
+    config.resizable = false;
+    table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    TEST_ASSERT_EQUAL(-1, oha_lpht_insert_batch(table, keys, num_keys, values, inserted));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        if (i < num_keys / 2) {
+            TEST_ASSERT_TRUE(inserted[i]);
+            TEST_ASSERT_NOT_NULL(values[i]);
+        } else {
+            TEST_ASSERT_FALSE(inserted[i]);
+            TEST_ASSERT_NULL(values[i]);
+        }
+    }
+    oha_lpht_destroy(table);
+}
+
+static void
+init_counter(const void * key, void * value, void * ctx)
+{
+    (void)key;
+    *(uint64_t *)value = 1;
+    (*(uint64_t *)ctx)++;
+}
+
+static void
+increment_counter(const void * key, void * value, void * ctx)
+{
+    (void)key;
+    (void)ctx;
+    (*(uint64_t *)value)++;
+}
+
+void
+test_upsert()
+{
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    // counts the occurrences of each key, key i occurs i + 1 times
+    const uint64_t num_keys = 500;
+    uint64_t new_keys = 0;
+    for (uint64_t round = 0; round < num_keys; round++) {
+        for (uint64_t i = round; i < num_keys; i++) {
+            uint64_t * value = oha_lpht_upsert(table, &i, init_counter, increment_counter, &new_keys);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_PTR(value, oha_lpht_look_up(table, &i));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT64(num_keys, new_keys);
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i + 1, *value);
+    }
+
+    // without callbacks an upsert is a plain insert
+    uint64_t key = 0;
+    uint64_t * value = oha_lpht_upsert(table, &key, NULL, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_UINT64(1, *value);
+    key = num_keys;
+    TEST_ASSERT_NOT_NULL(oha_lpht_upsert(table, &key, NULL, NULL, NULL));
+
+    struct oha_lpht_status status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT64(num_keys + 1, status.elems_in_use);
+    oha_lpht_destroy(table);
+}
+
+void
+test_hashed()
+{
+    enum { num_tables = 3 };
+    const uint64_t num_keys = 2000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    // the hash depends only on the key size, so a single hash is valid in all tables
+    struct oha_lpht * tables[num_tables];
+    for (size_t t = 0; t < num_tables; t++) {
+        config.value_size = sizeof(uint64_t) * (t + 1);
+        tables[t] = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(tables[t]);
+    }
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        const uint32_t hash = oha_lpht_hash_key(tables[0], &i);
+        for (size_t t = 0; t < num_tables; t++) {
+            TEST_ASSERT_EQUAL_UINT32(hash, oha_lpht_hash_key(tables[t], &i));
+            TEST_ASSERT_NULL(oha_lpht_look_up_hashed(tables[t], &i, hash));
+            uint64_t * value = oha_lpht_insert_hashed(tables[t], &i, hash);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = i + t;
+            TEST_ASSERT_EQUAL_PTR(value, oha_lpht_insert_hashed(tables[t], &i, hash));
+        }
+    }
+
+    // mixed with the hashing functions
+    for (uint64_t i = 0; i < num_keys; i++) {
+        const uint32_t hash = oha_lpht_hash_key(tables[0], &i);
+        for (size_t t = 0; t < num_tables; t++) {
+            uint64_t * value = oha_lpht_look_up_hashed(tables[t], &i, hash);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_PTR(value, oha_lpht_look_up(tables[t], &i));
+            TEST_ASSERT_EQUAL_UINT64(i + t, *value);
+            if (i % 2 == 0) {
+                TEST_ASSERT_EQUAL_PTR(value, oha_lpht_remove_hashed(tables[t], &i, hash));
+                TEST_ASSERT_NULL(oha_lpht_remove_hashed(tables[t], &i, hash));
+                TEST_ASSERT_NULL(oha_lpht_look_up(tables[t], &i));
+            }
+        }
+    }
+
+    for (size_t t = 0; t < num_tables; t++) {
+        struct oha_lpht_status status = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(tables[t], &status));
+        TEST_ASSERT_EQUAL_UINT64(num_keys / 2, status.elems_in_use);
+        oha_lpht_destroy(tables[t]);
+    }
+}
+
+// spreads the keys over the whole 64 bit range, the key words sum up to colliding hashes
+static uint64_t
+scattered_key(uint64_t i)
+{
+    return i * 2654435761U;
+}
+
+static struct oha_lpht_config
+create_growth_config(float max_load_factor, float growth_factor, float shrink_load_factor)
+{
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = max_load_factor;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 16;
+    config.resizable = true;
+    config.growth_factor = growth_factor;
+    config.shrink_load_factor = shrink_load_factor;
+    return config;
+}
+
+static void
+insert_scattered_keys(struct oha_lpht * table, uint64_t first, uint64_t last)
+{
+    for (uint64_t i = first; i < last; i++) {
+        const uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+    }
+}
+
+static void
+check_scattered_keys(struct oha_lpht * table, uint64_t first, uint64_t last, uint64_t end)
+{
+    for (uint64_t i = 0; i < end; i++) {
+        const uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        if (i >= first && i < last) {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key, *value);
+        } else {
+            TEST_ASSERT_NULL(value);
+        }
+    }
+}
+
+void
+test_growth_policy()
+{
+    const uint64_t num_keys = 20000;
+
+    // invalid growth and shrink settings
+    struct oha_lpht_config config = create_growth_config(0.8, 1.0, 0);
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+    config = create_growth_config(0.8, 2.0, 0.4);
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+    // too many growth steps to reach the element limit with the value buffers
+    config = create_growth_config(0.8, 1.0001, 0);
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+    config = create_growth_config(0.8, 1.001, 0);
+    struct oha_lpht * slow = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(slow);
+    oha_lpht_destroy(slow);
+
+    // load factors below 0.5 are taken as they are
+    config = create_growth_config(0.25, 0, 0);
+    config.resizable = false;
+    struct oha_lpht * sparse = oha_lpht_create(&config);
+    config.max_load_factor = 0.5;
+    struct oha_lpht * dense = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(sparse);
+    TEST_ASSERT_NOT_NULL(dense);
+    struct oha_lpht_status sparse_status = {0};
+    struct oha_lpht_status dense_status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(sparse, &sparse_status));
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(dense, &dense_status));
+    TEST_ASSERT_GREATER_THAN(dense_status.size_in_bytes, sparse_status.size_in_bytes);
+    oha_lpht_destroy(sparse);
+    oha_lpht_destroy(dense);
+
+    const float growth_factors[] = {0, 1.25, 1.5};
+    for (size_t g = 0; g < sizeof(growth_factors) / sizeof(growth_factors[0]); g++) {
+        config = create_growth_config(0.8, growth_factors[g], 0);
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        // a table grows by the growth factor at most, the default doubles the power of two bucket count
+        uint32_t max_elems = 0;
+        for (uint64_t i = 0; i < num_keys; i++) {
+            insert_scattered_keys(table, i, i + 1);
+            struct oha_lpht_status status = {0};
+            TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+            if (max_elems > 0 && status.max_elems != max_elems) {
+                const float growth = growth_factors[g] == 0 ? 2 : growth_factors[g];
+                TEST_ASSERT_TRUE(status.max_elems <= max_elems * growth + 1);
+            }
+            max_elems = status.max_elems;
+        }
+        check_scattered_keys(table, 0, num_keys, num_keys + 100);
+        oha_lpht_destroy(table);
+    }
+}
+
+void
+test_reserve_in_small_steps()
+{
+    // every reserve takes a whole growth step, otherwise the value buffers would run out after a few hundred reserves
+    struct oha_lpht_config config = create_growth_config(0.8, 1.5, 0);
+    config.max_elems = 1024;
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    struct oha_lpht_status created = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &created));
+
+    const uint64_t step = 64;
+    const uint64_t steps = 400;
+    uint32_t max_elems = created.max_elems;
+    for (uint64_t i = 0; i < steps; i++) {
+        TEST_ASSERT_EQUAL(0, oha_lpht_reserve(table, (uint32_t)((i + 1) * step)));
+        struct oha_lpht_status status = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+        TEST_ASSERT_GREATER_OR_EQUAL((i + 1) * step, status.max_elems);
+        if (status.max_elems != max_elems) {
+            TEST_ASSERT_GREATER_OR_EQUAL((uint32_t)(max_elems * 1.5), status.max_elems);
+        }
+        max_elems = status.max_elems;
+        insert_scattered_keys(table, i * step, (i + 1) * step);
+    }
+    check_scattered_keys(table, 0, steps * step, steps * step + 100);
+    oha_lpht_destroy(table);
+}
+
+void
+test_insert_batch_in_small_steps()
+{
+    // a full table grows by a whole growth step for a small batch, not just by the batch size
+    struct oha_lpht_config config = create_growth_config(0.8, 1.5, 0);
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    enum { batch_size = 64 };
+    const uint64_t batches = 4000;
+    uint64_t keys[batch_size];
+    void * values[batch_size];
+    uint32_t max_elems = 0;
+    uint64_t growths = 0;
+    for (uint64_t b = 0; b < batches; b++) {
+        for (uint64_t i = 0; i < batch_size; i++) {
+            keys[i] = scattered_key(b * batch_size + i);
+        }
+        TEST_ASSERT_EQUAL(0, oha_lpht_insert_batch(table, keys, batch_size, values, NULL));
+        for (uint64_t i = 0; i < batch_size; i++) {
+            *(uint64_t *)values[i] = keys[i];
+        }
+        struct oha_lpht_status status = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+        if (status.max_elems != max_elems) {
+            growths++;
+        }
+        max_elems = status.max_elems;
+    }
+    // 16 elements grow to 256000 in about 25 steps of 1.5
+    TEST_ASSERT_LESS_THAN(40, growths);
+    check_scattered_keys(table, 0, batches * batch_size, batches * batch_size + 100);
+    oha_lpht_destroy(table);
+}
+
+void
+test_shrink()
+{
+    const uint64_t num_keys = 20000;
+    const float growth_factors[] = {0, 1.5};
+    for (size_t g = 0; g < sizeof(growth_factors) / sizeof(growth_factors[0]); g++) {
+        struct oha_lpht_config config = create_growth_config(0.8, growth_factors[g], 0.1);
+        config.filter_bits_per_elem = 8;
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+        struct oha_lpht_status created = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &created));
+
+        insert_scattered_keys(table, 0, num_keys);
+        struct oha_lpht_status grown = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &grown));
+
+        // remove all but the last keys, the table shrinks on the way
+        for (uint64_t i = 0; i < num_keys - 100; i++) {
+            const uint64_t key = scattered_key(i);
+            uint64_t * value = oha_lpht_remove(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key, *value);
+        }
+        struct oha_lpht_status shrunk = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &shrunk));
+        TEST_ASSERT_EQUAL(100, shrunk.elems_in_use);
+        // the key buckets are released, the remaining elements keep their value buffers
+        TEST_ASSERT_LESS_THAN(grown.size_in_bytes, shrunk.size_in_bytes);
+        TEST_ASSERT_GREATER_OR_EQUAL(16, shrunk.max_elems);
+        check_scattered_keys(table, num_keys - 100, num_keys, num_keys);
+
+        // the table is usable as before
+        insert_scattered_keys(table, 0, num_keys - 100);
+        check_scattered_keys(table, 0, num_keys, num_keys + 100);
+
+        // a drained table returns all memory of its former size, the last removed value stays readable
+        for (uint64_t i = 0; i < num_keys; i++) {
+            const uint64_t key = scattered_key(i);
+            uint64_t * value = oha_lpht_remove(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key, *value);
+        }
+        insert_scattered_keys(table, 0, 1);
+        struct oha_lpht_status drained = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &drained));
+        TEST_ASSERT_EQUAL(1, drained.elems_in_use);
+        TEST_ASSERT_EQUAL(created.size_in_bytes, drained.size_in_bytes);
+        oha_lpht_destroy(table);
+    }
+}
+
+void
+test_grow_shrink_cycles()
+{
+    const uint64_t num_keys = 2000;
+    const float growth_factors[] = {0, 1.25};
+    for (size_t g = 0; g < sizeof(growth_factors) / sizeof(growth_factors[0]); g++) {
+        struct oha_lpht_config config = create_growth_config(0.8, growth_factors[g], 0.1);
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+        struct oha_lpht_status created = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &created));
+
+        // every cycle grows through all sizes, the value buffers of the former cycles are released or reused
+        for (uint64_t cycle = 0; cycle < 300; cycle++) {
+            insert_scattered_keys(table, cycle, cycle + num_keys);
+            for (uint64_t i = cycle; i < cycle + num_keys; i++) {
+                const uint64_t key = scattered_key(i);
+                TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+            }
+        }
+        insert_scattered_keys(table, 0, 1);
+        struct oha_lpht_status status = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+        TEST_ASSERT_EQUAL(created.size_in_bytes, status.size_in_bytes);
+        oha_lpht_destroy(table);
+    }
+}
+
+void
+test_grow_probe_length()
+{
+#if OHA_MAX_LOG_N_PROBING || defined(OHA_WITH_HASH_TAGS)
+    // the colliding keys exceed the probe sequence length bound of the log n probing or of the hash tags
+    TEST_IGNORE();
+#endif
+    const uint64_t num_keys = 4000;
+    uint32_t max_elems[2];
+    for (int with_probe_length = 0; with_probe_length <= 1; with_probe_length++) {
+        struct oha_lpht_config config = create_growth_config(0.95, 0, 0);
+        config.grow_probe_length = with_probe_length ? 4 : 0;
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        // groups of 8 keys, their 32 bit words sum up to the same hash
+        for (uint64_t i = 0; i < num_keys; i++) {
+            const uint64_t key = ((i % 8) << 32) | (i / 8 + 8 - i % 8);
+            uint64_t * value = oha_lpht_insert(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = i;
+        }
+        for (uint64_t i = 0; i < num_keys; i++) {
+            const uint64_t key = ((i % 8) << 32) | (i / 8 + 8 - i % 8);
+            uint64_t * value = oha_lpht_look_up(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+        }
+        struct oha_lpht_status status = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+        max_elems[with_probe_length] = status.max_elems;
+        oha_lpht_destroy(table);
+    }
+    // the long clusters let the table grow before it is full
+    TEST_ASSERT_GREATER_THAN(max_elems[0], max_elems[1]);
+}
+
+// all keys have the same hash, their 32 bit words sum up to the same value
+static uint64_t
+colliding_key(uint64_t i)
+{
+    return (i << 32) | (1000 - i);
+}
+
+void
+test_max_probe_length()
+{
+    struct oha_lpht_config config = create_growth_config(0.8, 0, 0);
+    config.max_probe_length = (uint16_t)INT16_MAX + 1;
+    TEST_ASSERT_NULL(oha_lpht_create(&config));
+
+    // a fixed size table rejects the fifth colliding key, until one of the others is removed
+    config.max_probe_length = 3;
+    config.max_elems = 100;
+    config.resizable = false;
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < 4; i++) {
+        const uint64_t key = colliding_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    uint64_t key = colliding_key(4);
+    TEST_ASSERT_NULL(oha_lpht_insert(table, &key));
+    TEST_ASSERT_NULL(oha_lpht_look_up(table, &key));
+    key = colliding_key(0);
+    TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    key = colliding_key(4);
+    uint64_t * value = oha_lpht_insert(table, &key);
+    TEST_ASSERT_NOT_NULL(value);
+    *value = 4;
+    for (uint64_t i = 1; i <= 4; i++) {
+        key = colliding_key(i);
+        value = oha_lpht_look_up(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+    oha_lpht_destroy(table);
+
+    // colliding keys do not let a resizable table grow, as long as it is less than half full
+    config = create_growth_config(0.8, 0, 0);
+    config.max_probe_length = 3;
+    table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    struct oha_lpht_status created = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &created));
+    uint32_t inserted = 0;
+    for (uint64_t i = 0; i < 1000; i++) {
+        key = colliding_key(i);
+        if (oha_lpht_insert(table, &key) != NULL) {
+            inserted++;
+        }
+    }
+    TEST_ASSERT_EQUAL(4, inserted);
+    struct oha_lpht_status status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL(created.max_elems, status.max_elems);
+    TEST_ASSERT_EQUAL(4, status.elems_in_use);
+    oha_lpht_destroy(table);
+
+    // well distributed keys fit into a short probe window of a resizable table with a high load factor
+    const uint64_t num_keys = 20000;
+    config = create_growth_config(0.9, 0, 0);
+    config.max_probe_length = 8;
+    table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    insert_scattered_keys(table, 0, num_keys);
+    check_scattered_keys(table, 0, num_keys, num_keys + 100);
+    oha_lpht_destroy(table);
+}
+
+void
+test_look_up_batch()
+{
+    enum { num_keys = 5000 };
+    static uint64_t keys[2 * num_keys];
+    static void * values[2 * num_keys];
+    for (uint8_t filter_bits = 0; filter_bits <= 8; filter_bits += 8) {
+        struct oha_lpht_config config;
+        memset(&config, 0, sizeof(config));
+        config.max_load_factor = LOAF_FACTOR;
+        config.key_size = sizeof(uint64_t);
+        config.value_size = sizeof(uint64_t);
+        config.max_elems = 1;
+        config.resizable = true;
+        config.filter_bits_per_elem = filter_bits;
+
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        // the colliding scattered keys lead to long and varying probe sequences, every second key is missing
+        for (uint64_t i = 0; i < 2 * num_keys; i++) {
+            keys[i] = scattered_key(i);
+            if (i % 2 == 0) {
+                uint64_t * value = oha_lpht_insert(table, &keys[i]);
+                TEST_ASSERT_NOT_NULL(value);
+                *value = keys[i];
+            }
+        }
+
+        TEST_ASSERT_EQUAL(0, oha_lpht_look_up_batch(table, keys, 0, values));
+        TEST_ASSERT_EQUAL(num_keys, oha_lpht_look_up_batch(table, keys, 2 * num_keys, values));
+        for (uint64_t i = 0; i < 2 * num_keys; i++) {
+            TEST_ASSERT_EQUAL_PTR(oha_lpht_look_up(table, &keys[i]), values[i]);
+            if (i % 2 == 0) {
+                TEST_ASSERT_NOT_NULL(values[i]);
+                TEST_ASSERT_EQUAL_UINT64(keys[i], *(uint64_t *)values[i]);
+            }
+        }
+
+        // less keys than look ups in flight
+        TEST_ASSERT_EQUAL(2, oha_lpht_look_up_batch(table, keys, 3, values));
+        TEST_ASSERT_NULL(values[1]);
+        oha_lpht_destroy(table);
+    }
+}
+
+void
+test_block_backward_shift()
+{
+    enum { num_keys = 100 };
+    const uint64_t num_rounds = 20000;
+    for (int block_backward_shift = 0; block_backward_shift <= 1; block_backward_shift++) {
+        struct oha_lpht_config config;
+        memset(&config, 0, sizeof(config));
+        config.max_load_factor = 0.95;
+        config.key_size = sizeof(uint64_t);
+        config.value_size = sizeof(uint64_t);
+        config.max_elems = num_keys;
+        config.occupied_bitmap = true;
+        config.block_backward_shift = block_backward_shift;
+
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        // churn on an almost full table, the long clusters also wrap around the end of the table
+        uint64_t keys[num_keys];
+        uint64_t next_key = 0;
+        for (size_t i = 0; i < num_keys; i++) {
+            keys[i] = scattered_key(next_key++);
+            uint64_t * value = oha_lpht_insert(table, &keys[i]);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = keys[i];
+        }
+        for (uint64_t round = 0; round < num_rounds; round++) {
+            const size_t i = (size_t)((round * 2654435761U) % num_keys);
+            uint64_t * value = oha_lpht_remove(table, &keys[i]);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(keys[i], *value);
+            TEST_ASSERT_NULL(oha_lpht_look_up(table, &keys[i]));
+
+            keys[i] = scattered_key(next_key++);
+            value = oha_lpht_insert(table, &keys[i]);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = keys[i];
+            if (round % 100 == 0) {
+                for (size_t k = 0; k < num_keys; k++) {
+                    value = oha_lpht_look_up(table, &keys[k]);
+                    TEST_ASSERT_NOT_NULL(value);
+                    TEST_ASSERT_EQUAL_UINT64(keys[k], *value);
+                }
+            }
+        }
+
+        // the occupied bitmap is still in sync
+        TEST_ASSERT_EQUAL(0, oha_lpht_iter_init(table));
+        struct oha_key_value_pair pair;
+        uint32_t iterated = 0;
+        while (oha_lpht_iter_next(table, &pair) == 0) {
+            TEST_ASSERT_EQUAL_UINT64(*(const uint64_t *)pair.key, *(uint64_t *)pair.value);
+            iterated++;
+        }
+        TEST_ASSERT_EQUAL(num_keys, iterated);
+        oha_lpht_destroy(table);
+    }
+}
+
+static bool
+is_even_value(const void * key, void * value, void * ctx)
+{
+    (void)key;
+    (*(uint64_t *)ctx)++;
+    return (*(uint64_t *)value % 2) == 0;
+}
+
+static bool
+erase_all(const void * key, void * value, void * ctx)
+{
+    (void)key;
+    (void)value;
+    (void)ctx;
+    return true;
+}
+
+void
+test_erase_if()
+{
+    const uint64_t num_keys = 5000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+
+    uint64_t calls = 0;
+    TEST_ASSERT_EQUAL_UINT32(num_keys / 2, oha_lpht_erase_if(table, is_even_value, &calls));
+    TEST_ASSERT_EQUAL_UINT64(num_keys, calls);
+
+    struct oha_lpht_status status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT64(num_keys / 2, status.elems_in_use);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        if (i % 2 == 0) {
+            TEST_ASSERT_NULL(value);
+        } else {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+        }
+    }
+
+    // freed value buckets are reused
+    for (uint64_t i = 0; i < num_keys; i += 2) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(num_keys, oha_lpht_erase_if(table, erase_all, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, oha_lpht_erase_if(table, erase_all, NULL));
+    TEST_ASSERT_EQUAL(0, oha_lpht_iter_init(table));
+    struct oha_key_value_pair pair;
+    TEST_ASSERT_EQUAL(1, oha_lpht_iter_next(table, &pair));
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_remove_batch()
+{
+    enum { num_keys = 1000 };
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = num_keys;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    uint64_t keys[num_keys];
+    void * values[num_keys];
+    for (uint64_t i = 0; i < num_keys; i++) {
+        keys[i] = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &keys[i]);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+
+    // remove the first half twice, the second time nothing is found
+    TEST_ASSERT_EQUAL_UINT32(num_keys / 2, oha_lpht_remove_batch(table, keys, num_keys / 2, values));
+    for (uint64_t i = 0; i < num_keys / 2; i++) {
+        TEST_ASSERT_NOT_NULL(values[i]);
+        TEST_ASSERT_EQUAL_UINT64(i, *(uint64_t *)values[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, oha_lpht_remove_batch(table, keys, num_keys / 2, values));
+    for (uint64_t i = 0; i < num_keys / 2; i++) {
+        TEST_ASSERT_NULL(values[i]);
+    }
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &keys[i]);
+        if (i < num_keys / 2) {
+            TEST_ASSERT_NULL(value);
+        } else {
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+        }
+    }
+
+    // values are optional
+    TEST_ASSERT_EQUAL_UINT32(num_keys / 2, oha_lpht_remove_batch(table, keys, num_keys, NULL));
+    struct oha_lpht_status status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL_UINT64(0, status.elems_in_use);
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_clear()
+{
+    const uint64_t num_keys = 500;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    // clear of an empty table
+    oha_lpht_clear(table);
+
+    struct oha_lpht_status status_before = {0};
+    for (uint64_t round = 0; round < 3; round++) {
+        for (uint64_t i = 0; i < num_keys; i++) {
+            uint64_t key = scattered_key(i + round);
+            uint64_t * value = oha_lpht_insert(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = i;
+        }
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status_before));
+        TEST_ASSERT_EQUAL_UINT64(num_keys, status_before.elems_in_use);
+
+        oha_lpht_clear(table);
+
+        struct oha_lpht_status status_after = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status_after));
+        TEST_ASSERT_EQUAL_UINT64(0, status_after.elems_in_use);
+        TEST_ASSERT_EQUAL_UINT64(status_before.max_elems, status_after.max_elems);
+        TEST_ASSERT_EQUAL_UINT64(status_before.size_in_bytes, status_after.size_in_bytes);
+        for (uint64_t i = 0; i < num_keys; i++) {
+            uint64_t key = scattered_key(i + round);
+            TEST_ASSERT_NULL(oha_lpht_look_up(table, &key));
+        }
+    }
+
+    // all value buckets are still usable
+    for (uint64_t i = 0; i < status_before.max_elems; i++) {
+        uint64_t * value = oha_lpht_insert(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    for (uint64_t i = 0; i < status_before.max_elems; i++) {
+        uint64_t * value = oha_lpht_look_up(table, &i);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+
+    // removes move buckets backwards, the clear still reaches all of them
+    for (uint64_t i = 0; i < status_before.max_elems; i += 2) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    oha_lpht_clear(table);
+    for (uint64_t i = 0; i < status_before.max_elems; i++) {
+        TEST_ASSERT_NULL(oha_lpht_look_up(table, &i));
+    }
+    uint64_t key = 7;
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &key));
+    TEST_ASSERT_NOT_NULL(oha_lpht_look_up(table, &key));
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_resize_scattered_keys()
+{
+    const uint64_t num_keys = 20000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(i, *value);
+    }
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_contains()
+{
+    const uint64_t num_keys = 5000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    uint64_t key = 0;
+    TEST_ASSERT_FALSE(oha_lpht_contains(table, &key));
+
+    // insert only even keys, odd keys are misses probing the same clusters
+    for (uint64_t i = 0; i < num_keys; i += 2) {
+        key = scattered_key(i);
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &key));
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        key = scattered_key(i);
+        TEST_ASSERT_EQUAL(i % 2 == 0, oha_lpht_contains(table, &key));
+        TEST_ASSERT_EQUAL(oha_lpht_contains(table, &key), oha_lpht_look_up(table, &key) != NULL);
+    }
+
+    for (uint64_t i = 0; i < num_keys; i += 4) {
+        key = scattered_key(i);
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        key = scattered_key(i);
+        TEST_ASSERT_EQUAL(i % 4 == 2, oha_lpht_contains(table, &key));
+    }
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_look_up_filter()
+{
+    const uint64_t num_keys = 20000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+    config.filter_bits_per_elem = 16;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    // insert only even keys, the filter is rebuild by each resize
+    for (uint64_t i = 0; i < num_keys; i += 2) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_look_up(table, &key);
+        TEST_ASSERT_EQUAL(i % 2 == 0, value != NULL);
+        TEST_ASSERT_EQUAL(i % 2 == 0, oha_lpht_contains(table, &key));
+        if (value != NULL) {
+            TEST_ASSERT_EQUAL_UINT64(i, *value);
+        }
+    }
+
+    // enough removes to rebuild the filter, the remaining keys must stay visible
+    for (uint64_t i = 0; i < num_keys; i += 4) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_EQUAL(i % 4 == 2, oha_lpht_contains(table, &key));
+    }
+    TEST_ASSERT_EQUAL(num_keys / 4, oha_lpht_erase_if(table, erase_all, NULL));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_FALSE(oha_lpht_contains(table, &key));
+    }
+
+    // the filter is empty after a clear
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &key));
+    }
+    oha_lpht_clear(table);
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_NULL(oha_lpht_look_up(table, &key));
+        TEST_ASSERT_NULL(oha_lpht_remove(table, &key));
+    }
+
+    oha_lpht_destroy(table);
+}
+
+// iterates over all elements and checks that every element is returned once
+static void
+check_iteration(struct oha_lpht * table, uint64_t num_keys)
+{
+    struct oha_lpht_status status = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+
+    struct oha_key_value_pair pair = {0};
+    uint64_t visited = 0;
+    uint64_t value_sum = 0;
+    uint64_t expected_sum = 0;
+    TEST_ASSERT_EQUAL(0, oha_lpht_iter_init(table));
+    while (oha_lpht_iter_next(table, &pair) == 0) {
+        TEST_ASSERT_EQUAL_PTR(pair.value, oha_lpht_look_up(table, pair.key));
+        value_sum += *(uint64_t *)pair.value;
+        visited++;
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        if (oha_lpht_contains(table, &key)) {
+            expected_sum += i;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(status.elems_in_use, visited);
+    TEST_ASSERT_EQUAL_UINT64(expected_sum, value_sum);
+}
+
+static void
+iterate_sparse_table(bool occupied_bitmap)
+{
+    const uint64_t num_keys = 20000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+    config.occupied_bitmap = occupied_bitmap;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    check_iteration(table, num_keys);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    check_iteration(table, num_keys);
+
+    // back shifts and the compaction of erase if move the elements between the buckets
+    for (uint64_t i = 0; i < num_keys; i += 3) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    }
+    check_iteration(table, num_keys);
+    uint64_t calls = 0;
+    oha_lpht_erase_if(table, is_even_value, &calls);
+    check_iteration(table, num_keys);
+
+    // only a few elements are left in a large table
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        if (i % 101 != 0) {
+            oha_lpht_remove(table, &key);
+        }
+    }
+    check_iteration(table, num_keys);
+
+    oha_lpht_clear(table);
+    check_iteration(table, num_keys);
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_iterate_sparse_table()
+{
+    iterate_sparse_table(false);
+    iterate_sparse_table(true);
+}
+
+// the iteration has to return the keys in the given order, every value is a copy of its key
+static void
+check_insertion_order(struct oha_lpht * table, const uint64_t * keys, size_t num_keys)
+{
+    struct oha_key_value_pair pair = {0};
+    TEST_ASSERT_EQUAL(0, oha_lpht_iter_init(table));
+    for (size_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL(0, oha_lpht_iter_next(table, &pair));
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *(uint64_t *)pair.key);
+        TEST_ASSERT_EQUAL_UINT64(keys[i], *(uint64_t *)pair.value);
+    }
+    TEST_ASSERT_EQUAL(1, oha_lpht_iter_next(table, &pair));
+}
+
+void
+test_insertion_order()
+{
+    const size_t num_keys = 3000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 1;
+    config.resizable = true;
+    config.insertion_ordered = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    uint64_t * expected = calloc(num_keys, sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(expected);
+
+    // the order is kept by all resizes
+    for (size_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+        expected[i] = key;
+    }
+    check_insertion_order(table, expected, num_keys);
+
+    // removed keys leave gaps, which are skipped
+    size_t in_use = 0;
+    for (size_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        if (i % 3 == 0) {
+            TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+        } else {
+            expected[in_use++] = key;
+        }
+    }
+    check_insertion_order(table, expected, in_use);
+
+    // inserted again, the keys are the youngest elements
+    for (size_t i = 0; i < num_keys; i += 3) {
+        uint64_t key = scattered_key(i);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+        expected[in_use++] = key;
+    }
+    TEST_ASSERT_EQUAL(num_keys, in_use);
+    check_insertion_order(table, expected, in_use);
+
+    uint64_t calls = 0;
+    oha_lpht_erase_if(table, is_even_value, &calls);
+    size_t odd_keys = 0;
+    for (size_t i = 0; i < in_use; i++) {
+        if (expected[i] % 2 == 1) {
+            expected[odd_keys++] = expected[i];
+        }
+    }
+    check_insertion_order(table, expected, odd_keys);
+
+    oha_lpht_clear(table);
+    check_insertion_order(table, expected, 0);
+
+    free(expected);
+    oha_lpht_destroy(table);
+}
+
+void
+test_insertion_order_compaction()
+{
+    const uint64_t window = 100;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = window;
+    config.insertion_ordered = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    uint64_t expected[100];
+    for (uint64_t key = 0; key < window; key++) {
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+    }
+
+    // fifo: the oldest element is replaced by a new one, the gaps are compacted by the inserts
+    for (uint64_t oldest = 0; oldest < 10000; oldest++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &oldest));
+        uint64_t key = oldest + window;
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+
+        if (oldest % 997 == 0) {
+            for (uint64_t i = 0; i < window; i++) {
+                expected[i] = oldest + 1 + i;
+            }
+            check_insertion_order(table, expected, window);
+        }
+    }
+
+    oha_lpht_destroy(table);
+}
+
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+void
+test_get_key_from_value()
+{
+    const uint64_t num_keys = 2000;
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = LOAF_FACTOR;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint32_t);
+    config.max_elems = 1;
+    config.resizable = true;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint32_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = (uint32_t)i;
+        TEST_ASSERT_EQUAL_MEMORY(&key, oha_lpht_get_key_from_value(table, value), sizeof(key));
+    }
+
+    // keys are moved by removes, resizes and the robin hood insertion
+    for (uint64_t i = 0; i < num_keys; i += 3) {
+        uint64_t key = scattered_key(i);
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+    }
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t key = scattered_key(i);
+        uint32_t * value = oha_lpht_look_up(table, &key);
+        if (i % 3 == 0) {
+            TEST_ASSERT_NULL(value);
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT32(i, *value);
+        TEST_ASSERT_EQUAL_MEMORY(&key, oha_lpht_get_key_from_value(table, value), sizeof(key));
+    }
+
+    oha_lpht_destroy(table);
+}
+#endif
+
+#if OHA_MAX_LOG_N_PROBING
+// the hash of a key is the sum of its 32 bit words and a constant, the key of 'i' has the given hash
+static uint64_t
+key_of_hash(uint32_t hash, uint64_t i)
+{
+    return (i << 32) | (uint32_t)(hash - (uint32_t)i - UINT32_C(2147483647));
+}
+
+void
+test_too_long_cluster()
+{
+    // 128 start buckets, a key is found at most log2(128) - 1 buckets behind its start bucket, the second cluster
+    // ends in the last bucket
+    const uint32_t hashes[] = {1000, 127};
+    for (size_t h = 0; h < sizeof(hashes) / sizeof(hashes[0]); h++) {
+        struct oha_lpht_config config = create_growth_config(0.8, 0, 0);
+        config.max_elems = 100;
+        config.resizable = false;
+        struct oha_lpht * table = oha_lpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        // a key in front of the colliding keys, which fill the whole probe window
+        uint64_t key = key_of_hash(hashes[h] - 1, 0);
+        uint64_t * value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+        uint64_t num_colliding = 0;
+        for (;; num_colliding++) {
+            key = key_of_hash(hashes[h], num_colliding);
+            value = oha_lpht_insert(table, &key);
+            if (value == NULL) {
+                break;
+            }
+            *value = key;
+        }
+        TEST_ASSERT_EQUAL_UINT64(7, num_colliding);
+
+        // the next key in front takes the place of the first colliding key, the shift of the others exceeds the
+        // probe window and is undone
+        key = key_of_hash(hashes[h] - 1, 1);
+        TEST_ASSERT_NULL(oha_lpht_insert(table, &key));
+        TEST_ASSERT_NULL(oha_lpht_look_up(table, &key));
+        struct oha_lpht_status status = {0};
+        TEST_ASSERT_EQUAL(0, oha_lpht_get_status(table, &status));
+        TEST_ASSERT_EQUAL(num_colliding + 1, status.elems_in_use);
+
+        key = key_of_hash(hashes[h] - 1, 0);
+        value = oha_lpht_look_up(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_UINT64(key, *value);
+        for (uint64_t i = 0; i < num_colliding; i++) {
+            key = key_of_hash(hashes[h], i);
+            value = oha_lpht_look_up(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key, *value);
+        }
+
+        // a removed colliding key makes room for the key in front
+        key = key_of_hash(hashes[h], num_colliding - 1);
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &key));
+        key = key_of_hash(hashes[h] - 1, 1);
+        value = oha_lpht_insert(table, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+        for (uint64_t i = 0; i < num_colliding - 1; i++) {
+            key = key_of_hash(hashes[h], i);
+            value = oha_lpht_look_up(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key, *value);
+        }
+        for (uint64_t i = 0; i < 2; i++) {
+            key = key_of_hash(hashes[h] - 1, i);
+            value = oha_lpht_look_up(table, &key);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT64(key, *value);
+        }
+        oha_lpht_destroy(table);
+    }
+}
+#endif
+
+#ifdef OHA_LPHT_HASH_TAG_SHIFT
+// the internals are only visible to the header only build with hash tags
+void
+test_rebuild_hash_from_tag()
+{
+    // only the fields, which select the start bucket, are set
+    struct oha_lpht table;
+    memset(&table, 0, sizeof(table));
+    table.key_size = sizeof(uint64_t);
+    table.start_indicies_minus_1 = OHA_LPHT_HASH_TAG_LOW_BITS;
+
+    struct oha_lpht_key_bucket * const bucket =
+        (struct oha_lpht_key_bucket *)malloc(sizeof(struct oha_lpht_key_bucket) + sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(bucket);
+    for (uint64_t i = 0; i < 10000; i++) {
+        // the hash reads the key as 32 bit words
+        const uint64_t scattered = scattered_key(i);
+        uint32_t key[2];
+        memcpy(key, &scattered, sizeof(key));
+        const uint32_t hash = oha_lpht_hash_32bit(key, sizeof(key));
+        memcpy(bucket->key_buffer, key, sizeof(key));
+        bucket->psl = (int8_t)(i % (OHA_LPHT_MAX_PSL + 1));
+        bucket->hash_tag = i_oha_lpht_hash_tag(hash);
+        // the probe sequence of a start bucket at the end wraps around
+        const uint32_t bucket_index = (hash + (uint32_t)bucket->psl) & table.start_indicies_minus_1;
+        TEST_ASSERT_EQUAL_HEX32(hash, i_oha_lpht_rebuild_hash(&table, bucket_index, bucket));
+
+        // smaller tables and the fast range hash the key, so a wrong tag does not matter
+        bucket->hash_tag++;
+        table.start_indicies_minus_1 = OHA_LPHT_HASH_TAG_LOW_BITS >> 1;
+        TEST_ASSERT_EQUAL_HEX32(hash, i_oha_lpht_rebuild_hash(&table, bucket_index, bucket));
+        table.start_indicies_minus_1 = OHA_LPHT_HASH_TAG_LOW_BITS;
+        table.fast_range = true;
+        TEST_ASSERT_EQUAL_HEX32(hash, i_oha_lpht_rebuild_hash(&table, bucket_index, bucket));
+        table.fast_range = false;
+    }
+    free(bucket);
+}
+#endif
+
 int
 main(void)
 {
@@ -392,6 +1751,36 @@ main(void)
     RUN_TEST(test_insert_with_resize);
     RUN_TEST(test_insert_look_up_resize);
     RUN_TEST(test_resize_stress_test);
+    RUN_TEST(test_insert_batch);
+    RUN_TEST(test_upsert);
+    RUN_TEST(test_hashed);
+    RUN_TEST(test_look_up_batch);
+    RUN_TEST(test_growth_policy);
+    RUN_TEST(test_reserve_in_small_steps);
+    RUN_TEST(test_insert_batch_in_small_steps);
+    RUN_TEST(test_shrink);
+    RUN_TEST(test_grow_shrink_cycles);
+    RUN_TEST(test_grow_probe_length);
+    RUN_TEST(test_max_probe_length);
+    RUN_TEST(test_block_backward_shift);
+    RUN_TEST(test_erase_if);
+    RUN_TEST(test_remove_batch);
+    RUN_TEST(test_clear);
+    RUN_TEST(test_resize_scattered_keys);
+    RUN_TEST(test_contains);
+    RUN_TEST(test_look_up_filter);
+    RUN_TEST(test_insertion_order);
+    RUN_TEST(test_insertion_order_compaction);
+    RUN_TEST(test_iterate_sparse_table);
+#ifdef OHA_WITH_KEY_FROM_VALUE_SUPPORT
+    RUN_TEST(test_get_key_from_value);
+#endif
+#if OHA_MAX_LOG_N_PROBING
+    RUN_TEST(test_too_long_cluster);
+#endif
+#ifdef OHA_LPHT_HASH_TAG_SHIFT
+    RUN_TEST(test_rebuild_hash_from_tag);
+#endif
 
     return UNITY_END();
 }
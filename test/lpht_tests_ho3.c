@@ -0,0 +1,3 @@
+#define OHA_WITH_KEY_FROM_VALUE_SUPPORT
+#include "../oha_ho.h"
+#include "lpht_tests.h"
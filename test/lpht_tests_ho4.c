@@ -0,0 +1,3 @@
+#define OHA_WITH_HASH_TAGS
+#include "../oha_ho.h"
+#include "lpht_tests.h"
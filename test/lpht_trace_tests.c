@@ -0,0 +1,138 @@
+#define OHA_WITH_TRACE_SUPPORT
+#include "../oha_ho.h"
+
+#include <stdio.h>
+#include <unity.h>
+
+#define TRACE_FILE "lpht_trace_tests.bin"
+#define RECORD_SIZE (1 + sizeof(uint64_t) + sizeof(uint64_t))
+
+/* Is run before every test, put unit init calls here. */
+void
+setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void
+tearDown(void)
+{
+    remove(TRACE_FILE);
+}
+
+static struct oha_lpht *
+create_table(void)
+{
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.max_load_factor = 0.9;
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = 100;
+
+    struct oha_lpht * table = oha_lpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    return table;
+}
+
+static void
+assert_record(FILE * fp, char operation, uint64_t key, uint64_t * last_time_stamp)
+{
+    uint8_t record[RECORD_SIZE];
+    TEST_ASSERT_EQUAL(1, fread(record, sizeof(record), 1, fp));
+    TEST_ASSERT_EQUAL_CHAR(operation, record[0]);
+
+    uint64_t record_key;
+    memcpy(&record_key, record + 1, sizeof(record_key));
+    TEST_ASSERT_EQUAL_UINT64(key, record_key);
+
+    uint64_t time_stamp;
+    memcpy(&time_stamp, record + 1 + sizeof(uint64_t), sizeof(time_stamp));
+    TEST_ASSERT(time_stamp >= *last_time_stamp);
+    *last_time_stamp = time_stamp;
+}
+
+void
+test_trace_start_stop()
+{
+    struct oha_lpht * table = create_table();
+
+    TEST_ASSERT_EQUAL(-1, oha_lpht_trace_stop(table));
+    TEST_ASSERT_EQUAL(-1, oha_lpht_trace_flush(table));
+    TEST_ASSERT_NOT_EQUAL(0, oha_lpht_trace_start(table, TRACE_FILE, 0));
+    TEST_ASSERT_NOT_EQUAL(0, oha_lpht_trace_start(table, "/nonexistent/dir/trace.bin", 4));
+
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_start(table, TRACE_FILE, 4));
+    TEST_ASSERT_NOT_EQUAL(0, oha_lpht_trace_start(table, TRACE_FILE, 4));
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_stop(table));
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_trace_records()
+{
+    struct oha_lpht * table = create_table();
+
+    // small buffer to force implicit writes
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_start(table, TRACE_FILE, 3));
+    for (uint64_t i = 0; i < 10; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &i));
+        TEST_ASSERT_NOT_NULL(oha_lpht_look_up(table, &i));
+    }
+    uint64_t missing = 42;
+    TEST_ASSERT_NULL(oha_lpht_look_up(table, &missing));
+    for (uint64_t i = 0; i < 10; i++) {
+        TEST_ASSERT_NOT_NULL(oha_lpht_remove(table, &i));
+    }
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_flush(table));
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_stop(table));
+
+    // not traced anymore
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &missing));
+
+    FILE * fp = fopen(TRACE_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    uint64_t time_stamp = 0;
+    for (uint64_t i = 0; i < 10; i++) {
+        assert_record(fp, '+', i, &time_stamp);
+        assert_record(fp, '?', i, &time_stamp);
+    }
+    assert_record(fp, '?', missing, &time_stamp);
+    for (uint64_t i = 0; i < 10; i++) {
+        assert_record(fp, '-', i, &time_stamp);
+    }
+    uint8_t end;
+    TEST_ASSERT_EQUAL(0, fread(&end, 1, 1, fp));
+    fclose(fp);
+
+    oha_lpht_destroy(table);
+}
+
+void
+test_trace_destroy_writes_records()
+{
+    struct oha_lpht * table = create_table();
+
+    TEST_ASSERT_EQUAL(0, oha_lpht_trace_start(table, TRACE_FILE, 100));
+    uint64_t key = 7;
+    TEST_ASSERT_NOT_NULL(oha_lpht_insert(table, &key));
+    oha_lpht_destroy(table);
+
+    FILE * fp = fopen(TRACE_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    uint64_t time_stamp = 0;
+    assert_record(fp, '+', key, &time_stamp);
+    fclose(fp);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_trace_start_stop);
+    RUN_TEST(test_trace_records);
+    RUN_TEST(test_trace_destroy_writes_records);
+
+    return UNITY_END();
+}
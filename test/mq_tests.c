@@ -0,0 +1,3 @@
+#include "../oha.h"
+
+#include "mq_tests.h"
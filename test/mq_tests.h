@@ -0,0 +1,212 @@
+#include <pthread.h>
+#include "tests_common.h"
+
+#define NUM_THREADS 4
+
+void
+test_mq_single_thread()
+{
+    const uint64_t num_keys = 5000;
+    struct oha_mq_config config;
+    memset(&config, 0, sizeof(config));
+    config.shard_config.table_config = create_table_config(64, 0.8, true);
+    TEST_ASSERT_NULL(oha_mq_create(&config));
+    config.num_shards = 7;
+    struct oha_mq * mq = oha_mq_create(&config);
+    TEST_ASSERT_NOT_NULL(mq);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL(0, oha_mq_insert(mq, &i, &i, (int64_t)i, -1));
+    }
+    // the value and the deadline of an existing element are not changed
+    uint64_t key = 10;
+    uint64_t value = 0;
+    TEST_ASSERT_EQUAL(1, oha_mq_insert(mq, &key, &value, 0, 9));
+    TEST_ASSERT_TRUE(oha_mq_look_up(mq, &key, 9, &value));
+    TEST_ASSERT_EQUAL_UINT64(key, value);
+    TEST_ASSERT_FALSE(oha_mq_look_up(mq, &key, 10, NULL));
+    // unless it is expired
+    value = 0;
+    TEST_ASSERT_EQUAL(0, oha_mq_insert(mq, &key, &value, 20, 10));
+    TEST_ASSERT_TRUE(oha_mq_look_up(mq, &key, 10, &value));
+    TEST_ASSERT_EQUAL_UINT64(0, value);
+
+    TEST_ASSERT_EQUAL(0, oha_mq_set_deadline(mq, &key, (int64_t)num_keys));
+    key = 11;
+    TEST_ASSERT_TRUE(oha_mq_remove(mq, &key, &value));
+    TEST_ASSERT_EQUAL_UINT64(key, value);
+    TEST_ASSERT_FALSE(oha_mq_remove(mq, &key, NULL));
+    TEST_ASSERT_EQUAL(-1, oha_mq_set_deadline(mq, &key, 0));
+
+    // a single consumer gets exactly the due elements
+    TEST_ASSERT_EQUAL(10, oha_mq_expire(mq, 10, UINT32_MAX, NULL, NULL));
+    TEST_ASSERT_EQUAL(5, oha_mq_expire(mq, 1000, 5, NULL, NULL));
+    TEST_ASSERT_EQUAL(num_keys - 17, oha_mq_expire(mq, (int64_t)num_keys - 1, UINT32_MAX, NULL, NULL));
+    key = 10;
+    TEST_ASSERT_TRUE(oha_mq_look_up(mq, &key, (int64_t)num_keys - 1, NULL));
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_EQUAL(0, oha_mq_get_status(mq, &status));
+    TEST_ASSERT_EQUAL(1, status.elems_in_use);
+    oha_mq_destroy(mq);
+}
+
+// the unity asserts are not thread safe, so the threads only count their errors
+struct consumer {
+    pthread_t thread;
+    struct oha_mq * mq;
+    uint32_t * expired_per_key; // each element must be expired once
+    int64_t now;
+    uint32_t expired;
+    uint32_t errors;
+};
+
+static void
+count_expired(const void * key, void * value, void * ctx)
+{
+    struct consumer * consumer = ctx;
+    if (*(const uint64_t *)key != *(uint64_t *)value) {
+        consumer->errors++;
+    }
+    __atomic_fetch_add(&consumer->expired_per_key[*(const uint64_t *)key], 1, __ATOMIC_RELAXED);
+}
+
+static void *
+consume(void * ctx)
+{
+    struct consumer * consumer = ctx;
+    uint32_t expired;
+    while ((expired = oha_mq_expire(consumer->mq, consumer->now, 100, count_expired, consumer)) > 0) {
+        consumer->expired += expired;
+    }
+    return NULL;
+}
+
+static void
+concurrent_expire(bool monotone_deadlines)
+{
+    const uint64_t num_keys = 100000;
+    struct oha_mq_config config;
+    memset(&config, 0, sizeof(config));
+    config.shard_config.table_config = create_table_config(64, 0.8, true);
+    config.shard_config.monotone_deadlines = monotone_deadlines;
+    config.num_shards = 4 * NUM_THREADS;
+    struct oha_mq * mq = oha_mq_create(&config);
+    TEST_ASSERT_NOT_NULL(mq);
+    uint32_t * expired_per_key = calloc(num_keys, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(expired_per_key);
+
+    // the deadline of each key is the key
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL(0, oha_mq_insert(mq, &i, &i, (int64_t)i, -1));
+    }
+
+    // the first round expires the first half, the second round the rest
+    for (int64_t now = (int64_t)num_keys / 2 - 1; now < (int64_t)num_keys; now += (int64_t)num_keys / 2) {
+        struct consumer consumers[NUM_THREADS];
+        uint32_t expired = 0;
+        for (size_t i = 0; i < NUM_THREADS; i++) {
+            consumers[i] = (struct consumer){0, mq, expired_per_key, now, 0, 0};
+            TEST_ASSERT_EQUAL(0, pthread_create(&consumers[i].thread, NULL, consume, &consumers[i]));
+        }
+        for (size_t i = 0; i < NUM_THREADS; i++) {
+            TEST_ASSERT_EQUAL(0, pthread_join(consumers[i].thread, NULL));
+            TEST_ASSERT_EQUAL(0, consumers[i].errors);
+            expired += consumers[i].expired;
+        }
+        TEST_ASSERT_EQUAL(num_keys / 2, expired);
+        for (uint64_t i = 0; i < num_keys; i++) {
+            TEST_ASSERT_EQUAL(i <= (uint64_t)now, expired_per_key[i]);
+        }
+    }
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_EQUAL(0, oha_mq_get_status(mq, &status));
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+    free(expired_per_key);
+    oha_mq_destroy(mq);
+}
+
+void
+test_mq_concurrent_expire()
+{
+    concurrent_expire(false);
+    concurrent_expire(true);
+}
+
+struct producer {
+    pthread_t thread;
+    struct oha_mq * mq;
+    uint64_t first_key;
+    uint64_t num_keys;
+    uint32_t errors;
+};
+
+// inserts with the deadline 0 and refreshes every second key, so the consumers race with the producers
+static void *
+produce(void * ctx)
+{
+    struct producer * producer = ctx;
+    for (uint64_t i = producer->first_key; i < producer->first_key + producer->num_keys; i++) {
+        if (oha_mq_insert(producer->mq, &i, &i, 0, -1) != 0) {
+            producer->errors++;
+        }
+        if (i % 2 == 0) {
+            (void)oha_mq_set_deadline(producer->mq, &i, 0);
+        }
+    }
+    return NULL;
+}
+
+void
+test_mq_concurrent_producers_consumers()
+{
+    const uint64_t keys_per_producer = 20000;
+    struct oha_mq_config config;
+    memset(&config, 0, sizeof(config));
+    config.shard_config.table_config = create_table_config(64, 0.8, true);
+    config.num_shards = 4 * NUM_THREADS;
+    struct oha_mq * mq = oha_mq_create(&config);
+    TEST_ASSERT_NOT_NULL(mq);
+    uint32_t * expired_per_key = calloc(NUM_THREADS * keys_per_producer, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(expired_per_key);
+
+    struct producer producers[NUM_THREADS];
+    struct consumer consumers[NUM_THREADS];
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        producers[i] = (struct producer){0, mq, i * keys_per_producer, keys_per_producer, 0};
+        consumers[i] = (struct consumer){0, mq, expired_per_key, 0, 0, 0};
+        TEST_ASSERT_EQUAL(0, pthread_create(&producers[i].thread, NULL, produce, &producers[i]));
+        TEST_ASSERT_EQUAL(0, pthread_create(&consumers[i].thread, NULL, consume, &consumers[i]));
+    }
+    uint32_t expired = 0;
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_join(producers[i].thread, NULL));
+        TEST_ASSERT_EQUAL(0, pthread_join(consumers[i].thread, NULL));
+        TEST_ASSERT_EQUAL(0, producers[i].errors);
+        TEST_ASSERT_EQUAL(0, consumers[i].errors);
+        expired += consumers[i].expired;
+    }
+    // the consumers could have stopped before the last inserts
+    struct consumer last = {0, mq, expired_per_key, 0, 0, 0};
+    consume(&last);
+    TEST_ASSERT_EQUAL(0, last.errors);
+    expired += last.expired;
+    TEST_ASSERT_EQUAL(NUM_THREADS * keys_per_producer, expired);
+    for (uint64_t i = 0; i < NUM_THREADS * keys_per_producer; i++) {
+        TEST_ASSERT_EQUAL(1, expired_per_key[i]);
+    }
+
+    free(expired_per_key);
+    oha_mq_destroy(mq);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_mq_single_thread);
+    RUN_TEST(test_mq_concurrent_expire);
+    RUN_TEST(test_mq_concurrent_producers_consumers);
+    return UNITY_END();
+}
@@ -0,0 +1,3 @@
+#include "../oha.h"
+
+#include "rxh_tests.h"
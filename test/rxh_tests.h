@@ -0,0 +1,186 @@
+#include "tests_common.h"
+
+static int64_t
+scattered_key(uint64_t i)
+{
+    return (int64_t)((i * 2654435761U) % 1000003) - 500000;
+}
+
+void
+test_rxh_create_destroy()
+{
+    struct oha_rxh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    TEST_ASSERT_NULL(oha_rxh_create(&config));
+
+    config.max_elems = 100;
+    struct oha_rxh * heap = oha_rxh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_NULL(oha_rxh_find_min(heap, NULL));
+    TEST_ASSERT_NULL(oha_rxh_delete_min(heap));
+
+    struct oha_bh_status status;
+    TEST_ASSERT_EQUAL(0, oha_rxh_get_status(heap, &status));
+    TEST_ASSERT_EQUAL(100, status.max_elems);
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+    TEST_ASSERT_GREATER_THAN(100 * sizeof(int64_t), status.size_in_bytes);
+    oha_rxh_destroy(heap);
+}
+
+void
+test_rxh_sort()
+{
+    const uint32_t num_elems = 10000;
+    struct oha_rxh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    config.max_elems = num_elems;
+    struct oha_rxh * heap = oha_rxh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    // before the first delete min every key is valid, also the full 64 bit range
+    for (uint64_t i = 0; i < num_elems - 2; i++) {
+        int64_t * value = oha_rxh_insert(heap, scattered_key(i));
+        TEST_ASSERT_NOT_NULL(value);
+        *value = scattered_key(i);
+    }
+    *(int64_t *)oha_rxh_insert(heap, INT64_MIN) = INT64_MIN;
+    *(int64_t *)oha_rxh_insert(heap, INT64_MAX) = INT64_MAX;
+    // full fixed size heap
+    TEST_ASSERT_NULL(oha_rxh_insert(heap, 0));
+
+    int64_t last = INT64_MIN;
+    for (uint64_t i = 0; i < num_elems; i++) {
+        int64_t key;
+        int64_t * value = oha_rxh_find_min(heap, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_INT64(key, *value);
+        TEST_ASSERT_EQUAL_PTR(value, oha_rxh_delete_min(heap));
+        TEST_ASSERT_TRUE(last <= key);
+        last = key;
+    }
+    TEST_ASSERT_EQUAL_INT64(INT64_MAX, last);
+    TEST_ASSERT_NULL(oha_rxh_delete_min(heap));
+    oha_rxh_destroy(heap);
+}
+
+void
+test_rxh_monotone()
+{
+    const uint32_t num_rounds = 20000;
+    struct oha_rxh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    config.max_elems = 8;
+    config.resizable = true;
+    struct oha_rxh * heap = oha_rxh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    // timestamps: every round schedules two keys behind the current time and removes the earliest one
+    int64_t now = 0;
+    int64_t last = INT64_MIN;
+    for (uint64_t i = 0; i < num_rounds; i++) {
+        for (uint64_t k = 0; k < 2; k++) {
+            const int64_t key = now + (scattered_key(2 * i + k) & 0xFFFF);
+            int64_t * value = oha_rxh_insert(heap, key);
+            TEST_ASSERT_NOT_NULL(value);
+            *value = key;
+        }
+        int64_t key;
+        int64_t * value = oha_rxh_find_min(heap, &key);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL_INT64(key, *value);
+        TEST_ASSERT_TRUE(last <= key);
+        oha_rxh_delete_min(heap);
+        last = now = key;
+    }
+
+    struct oha_bh_status status;
+    TEST_ASSERT_EQUAL(0, oha_rxh_get_status(heap, &status));
+    TEST_ASSERT_EQUAL(num_rounds, status.elems_in_use);
+
+    // keys before the last minimum are ordered as the last minimum, but keep their key
+    int64_t * past = oha_rxh_insert(heap, last - 1000);
+    TEST_ASSERT_NOT_NULL(past);
+    int64_t key;
+    TEST_ASSERT_EQUAL_PTR(past, oha_rxh_find_min(heap, &key));
+    TEST_ASSERT_EQUAL_INT64(last - 1000, key);
+    TEST_ASSERT_EQUAL_INT64(last - 1000, oha_rxh_get_key(heap, past));
+    oha_rxh_delete_min(heap);
+
+    while (oha_rxh_find_min(heap, &key) != NULL) {
+        TEST_ASSERT_TRUE(last <= key);
+        last = key;
+        oha_rxh_delete_min(heap);
+    }
+    oha_rxh_destroy(heap);
+}
+
+void
+test_rxh_change_key_remove()
+{
+    const uint32_t num_elems = 5000;
+    struct oha_rxh_config config;
+    memset(&config, 0, sizeof(config));
+    config.value_size = sizeof(int64_t);
+    config.max_elems = 16;
+    config.resizable = true;
+    struct oha_rxh * heap = oha_rxh_create(&config);
+    TEST_ASSERT_NOT_NULL(heap);
+
+    int64_t ** values = calloc(num_elems, sizeof(int64_t *));
+    TEST_ASSERT_NOT_NULL(values);
+    for (uint64_t i = 0; i < num_elems; i++) {
+        values[i] = oha_rxh_insert(heap, (int64_t)i);
+        TEST_ASSERT_NOT_NULL(values[i]);
+        *values[i] = (int64_t)i;
+    }
+    // sorts out the first keys
+    TEST_ASSERT_EQUAL_PTR(values[0], oha_rxh_find_min(heap, NULL));
+
+    // increase and decrease keys, the value keeps the new key
+    for (uint64_t i = 0; i < num_elems; i++) {
+        *values[i] = scattered_key(i) + 500000;
+        TEST_ASSERT_EQUAL(0, oha_rxh_change_key(heap, values[i], *values[i]));
+        TEST_ASSERT_EQUAL_INT64(*values[i], oha_rxh_get_key(heap, values[i]));
+    }
+    uint32_t removed = 0;
+    for (uint64_t i = 0; i < num_elems; i += 3) {
+        TEST_ASSERT_EQUAL(0, oha_rxh_remove(heap, values[i]));
+        // already removed
+        TEST_ASSERT_EQUAL(-1, oha_rxh_remove(heap, values[i]));
+        TEST_ASSERT_EQUAL(-1, oha_rxh_change_key(heap, values[i], 0));
+        removed++;
+    }
+
+    struct oha_bh_status status;
+    TEST_ASSERT_EQUAL(0, oha_rxh_get_status(heap, &status));
+    TEST_ASSERT_EQUAL(num_elems - removed, status.elems_in_use);
+
+    int64_t last = INT64_MIN;
+    int64_t key;
+    int64_t * value;
+    while ((value = oha_rxh_find_min(heap, &key)) != NULL) {
+        TEST_ASSERT_EQUAL_INT64(key, *value);
+        TEST_ASSERT_TRUE(last <= key);
+        last = key;
+        oha_rxh_delete_min(heap);
+        removed++;
+    }
+    TEST_ASSERT_EQUAL(num_elems, removed);
+
+    free(values);
+    oha_rxh_destroy(heap);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rxh_create_destroy);
+    RUN_TEST(test_rxh_sort);
+    RUN_TEST(test_rxh_monotone);
+    RUN_TEST(test_rxh_change_key_remove);
+    return UNITY_END();
+}
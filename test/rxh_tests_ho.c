@@ -0,0 +1,2 @@
+#include "../oha_ho.h"
+#include "rxh_tests.h"
@@ -0,0 +1,33 @@
+#ifndef OHA_TESTS_COMMON_H_
+#define OHA_TESTS_COMMON_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+/* Is run before every test, put unit init calls here. */
+void
+setUp(void)
+{
+}
+/* Is run after every test, put unit clean-up calls here. */
+void
+tearDown(void)
+{
+}
+
+// the table of the containers on top of the lpht, 64 bit keys and values
+static inline struct oha_lpht_config
+create_table_config(uint32_t max_elems, float max_load_factor, bool resizable)
+{
+    struct oha_lpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.key_size = sizeof(uint64_t);
+    config.value_size = sizeof(uint64_t);
+    config.max_elems = max_elems;
+    config.max_load_factor = max_load_factor;
+    config.resizable = resizable;
+    return config;
+}
+
+#endif
@@ -0,0 +1,3 @@
+#include "../oha.h"
+
+#include "tpht_tests.h"
@@ -0,0 +1,327 @@
+#include "tests_common.h"
+
+struct expired_ctx {
+    uint32_t calls;
+    uint64_t max_key;
+};
+
+static void
+count_expired(const void * key, void * value, void * ctx)
+{
+    struct expired_ctx * expired = ctx;
+    const uint64_t k = *(const uint64_t *)key;
+    TEST_ASSERT_EQUAL_UINT64(k, *(uint64_t *)value);
+    if (expired->calls == 0 || k > expired->max_key) {
+        expired->max_key = k;
+    }
+    expired->calls++;
+}
+
+void
+test_tpht_expire()
+{
+    const uint64_t num_keys = 10000;
+    struct oha_tpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(100, 0.9, true);
+    config.heap_arity = 4;
+    struct oha_tpht * table = oha_tpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    int64_t deadline;
+    TEST_ASSERT_FALSE(oha_tpht_next_deadline(table, &deadline));
+
+    // reverse order, the deadline of key i is i
+    for (uint64_t i = num_keys; i-- > 0;) {
+        uint64_t * value = oha_tpht_insert(table, &i, (int64_t)i, -1, NULL);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    TEST_ASSERT_TRUE(oha_tpht_next_deadline(table, &deadline));
+    TEST_ASSERT_EQUAL_INT64(0, deadline);
+
+    struct expired_ctx ctx = {0, 0};
+    TEST_ASSERT_EQUAL(0, oha_tpht_expire(table, -1, count_expired, &ctx));
+    TEST_ASSERT_EQUAL(0, ctx.calls);
+
+    for (int64_t now = 99; now < (int64_t)num_keys; now += 100) {
+        TEST_ASSERT_EQUAL(100, oha_tpht_expire(table, now, count_expired, &ctx));
+        TEST_ASSERT_EQUAL_UINT64((uint64_t)now, ctx.max_key);
+        uint64_t key = (uint64_t)now;
+        TEST_ASSERT_NULL(oha_tpht_look_up(table, &key, INT64_MIN));
+        key++;
+        if (key < num_keys) {
+            TEST_ASSERT_NOT_NULL(oha_tpht_look_up(table, &key, now));
+            TEST_ASSERT_TRUE(oha_tpht_next_deadline(table, &deadline));
+            TEST_ASSERT_EQUAL_INT64(now + 1, deadline);
+        }
+    }
+    TEST_ASSERT_EQUAL(num_keys, ctx.calls);
+    TEST_ASSERT_FALSE(oha_tpht_next_deadline(table, &deadline));
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_EQUAL(0, oha_tpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+
+    oha_tpht_destroy(table);
+}
+
+// the deadline of a key, spread over a range of 1000
+static int64_t
+scattered_deadline(uint64_t key)
+{
+    return (int64_t)(key * 2654435761U % 1000);
+}
+
+struct due_ctx {
+    uint32_t calls;
+    int64_t now;
+};
+
+static void
+check_due(const void * key, void * value, void * ctx)
+{
+    struct due_ctx * due = ctx;
+    const uint64_t k = *(const uint64_t *)key;
+    TEST_ASSERT_EQUAL_UINT64(k, *(uint64_t *)value);
+    TEST_ASSERT_LESS_OR_EQUAL_INT64(due->now, scattered_deadline(k));
+    due->calls++;
+}
+
+void
+test_tpht_expire_batches()
+{
+    // many equal and scattered deadlines become due at once, more than one batch of the binary heap
+    const uint64_t num_keys = 10000;
+    struct oha_tpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(num_keys, 0.9, false);
+    config.heap_arity = 4;
+    struct oha_tpht * table = oha_tpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_tpht_insert(table, &i, scattered_deadline(i), -1, NULL);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+
+    struct due_ctx ctx = {0, 0};
+    for (int64_t now = 0; now < 1000; now += 37) {
+        ctx.now = now;
+        uint32_t due = 0;
+        for (uint64_t i = 0; i < num_keys; i++) {
+            const int64_t deadline = scattered_deadline(i);
+            due += deadline <= now && deadline > now - 37;
+        }
+        const uint32_t calls = ctx.calls;
+        TEST_ASSERT_EQUAL(due, oha_tpht_expire(table, now, check_due, &ctx));
+        TEST_ASSERT_EQUAL(calls + due, ctx.calls);
+        for (uint64_t i = 0; i < num_keys; i++) {
+            TEST_ASSERT_EQUAL(scattered_deadline(i) > now, oha_tpht_look_up(table, &i, INT64_MIN) != NULL);
+        }
+        int64_t deadline;
+        if (oha_tpht_next_deadline(table, &deadline)) {
+            TEST_ASSERT_GREATER_THAN_INT64(now, deadline);
+        }
+    }
+
+    oha_tpht_destroy(table);
+}
+
+void
+test_tpht_lazy_look_up()
+{
+    // both deadline heaps replace the expired element
+    for (int monotone = 0; monotone <= 1; monotone++) {
+        struct oha_tpht_config config;
+        memset(&config, 0, sizeof(config));
+        config.table_config = create_table_config(100, 0.9, false);
+        config.heap_arity = 4;
+        config.monotone_deadlines = monotone;
+        struct oha_tpht * table = oha_tpht_create(&config);
+        TEST_ASSERT_NOT_NULL(table);
+
+        uint64_t key = 42;
+        bool inserted = false;
+        uint64_t * value = oha_tpht_insert(table, &key, 1000, 0, &inserted);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_TRUE(inserted);
+        *value = key;
+        TEST_ASSERT_EQUAL_PTR(value, oha_tpht_look_up(table, &key, 999));
+        TEST_ASSERT_NULL(oha_tpht_look_up(table, &key, 1000));
+
+        // the expired element is kept until it is passed to the callback
+        TEST_ASSERT_EQUAL_PTR(value, oha_tpht_insert(table, &key, 5000, 999, &inserted));
+        TEST_ASSERT_FALSE(inserted);
+        TEST_ASSERT_EQUAL_INT64(1000, oha_tpht_get_deadline(table, value));
+        struct expired_ctx ctx = {0, 0};
+        TEST_ASSERT_EQUAL(1, oha_tpht_expire(table, 1000, count_expired, &ctx));
+        TEST_ASSERT_EQUAL(1, ctx.calls);
+        TEST_ASSERT_NULL(oha_tpht_look_up(table, &key, INT64_MIN));
+
+        // unless an insert replaces it before
+        value = oha_tpht_insert(table, &key, 1000, 0, &inserted);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = key;
+        TEST_ASSERT_EQUAL_PTR(value, oha_tpht_insert(table, &key, 5000, 1000, &inserted));
+        TEST_ASSERT_TRUE(inserted);
+        TEST_ASSERT_EQUAL_INT64(5000, oha_tpht_get_deadline(table, value));
+        TEST_ASSERT_EQUAL_PTR(value, oha_tpht_look_up(table, &key, 1000));
+        TEST_ASSERT_EQUAL(0, oha_tpht_expire(table, 4999, count_expired, &ctx));
+        TEST_ASSERT_EQUAL(1, oha_tpht_expire(table, 5000, count_expired, &ctx));
+        TEST_ASSERT_EQUAL(2, ctx.calls);
+
+        oha_tpht_destroy(table);
+    }
+}
+
+void
+test_tpht_set_deadline_remove()
+{
+    const uint64_t num_keys = 100;
+    struct oha_tpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(num_keys, 0.9, false);
+    config.heap_arity = 4;
+    struct oha_tpht * table = oha_tpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_tpht_insert(table, &i, 10, 0, NULL);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    // fixed size table is full
+    uint64_t key = num_keys;
+    TEST_ASSERT_NULL(oha_tpht_insert(table, &key, 10, 0, NULL));
+
+    // odd keys are refreshed, every fourth key is removed
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_tpht_look_up(table, &i, 0);
+        TEST_ASSERT_NOT_NULL(value);
+        if (i % 2 == 1) {
+            TEST_ASSERT_EQUAL(0, oha_tpht_set_deadline(table, value, 20));
+            TEST_ASSERT_EQUAL_INT64(20, oha_tpht_get_deadline(table, value));
+        } else if (i % 4 == 0) {
+            TEST_ASSERT_EQUAL_PTR(value, oha_tpht_remove(table, &i));
+            TEST_ASSERT_NULL(oha_tpht_remove(table, &i));
+        }
+    }
+
+    struct expired_ctx ctx = {0, 0};
+    TEST_ASSERT_EQUAL(num_keys / 4, oha_tpht_expire(table, 10, count_expired, &ctx));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, oha_tpht_look_up(table, &i, 10) != NULL);
+    }
+    // no callback is needed
+    TEST_ASSERT_EQUAL(num_keys / 2, oha_tpht_expire(table, INT64_MAX, NULL, NULL));
+
+    // removed elements free their place
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_NOT_NULL(oha_tpht_insert(table, &i, 0, -1, NULL));
+    }
+
+    oha_tpht_destroy(table);
+}
+
+// reverses the deadlines, the value of each element is its key
+static int64_t
+reversed_deadline(const void * key, void * value, void * ctx)
+{
+    TEST_ASSERT_EQUAL_UINT64(*(const uint64_t *)key, *(uint64_t *)value);
+    return *(int64_t *)ctx - (int64_t)(*(const uint64_t *)key);
+}
+
+void
+test_tpht_reset_deadlines()
+{
+    const uint64_t num_keys = 5000;
+    struct oha_tpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(100, 0.9, true);
+    config.heap_arity = 4;
+    struct oha_tpht * table = oha_tpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_tpht_insert(table, &i, (int64_t)i, -1, NULL);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    int64_t max_deadline = (int64_t)num_keys - 1;
+    TEST_ASSERT_EQUAL(0, oha_tpht_reset_deadlines(table, reversed_deadline, &max_deadline));
+
+    int64_t deadline;
+    TEST_ASSERT_TRUE(oha_tpht_next_deadline(table, &deadline));
+    TEST_ASSERT_EQUAL_INT64(0, deadline);
+    uint64_t key = 0;
+    TEST_ASSERT_EQUAL_INT64(max_deadline, oha_tpht_get_deadline(table, oha_tpht_look_up(table, &key, 0)));
+
+    // the highest keys expire first now
+    struct expired_ctx ctx = {0, 0};
+    TEST_ASSERT_EQUAL(num_keys / 2, oha_tpht_expire(table, (int64_t)num_keys / 2 - 1, count_expired, &ctx));
+    for (uint64_t i = 0; i < num_keys; i++) {
+        TEST_ASSERT_EQUAL(i < num_keys / 2, oha_tpht_look_up(table, &i, INT64_MIN) != NULL);
+    }
+    TEST_ASSERT_EQUAL(num_keys / 2, oha_tpht_expire(table, INT64_MAX, NULL, NULL));
+
+    oha_tpht_destroy(table);
+}
+
+void
+test_tpht_monotone_deadlines()
+{
+    const uint64_t num_keys = 10000;
+    struct oha_tpht_config config;
+    memset(&config, 0, sizeof(config));
+    config.table_config = create_table_config(100, 0.9, true);
+    config.heap_arity = 4;
+    config.monotone_deadlines = true;
+    struct oha_tpht * table = oha_tpht_create(&config);
+    TEST_ASSERT_NOT_NULL(table);
+
+    for (uint64_t i = 0; i < num_keys; i++) {
+        uint64_t * value = oha_tpht_insert(table, &i, (int64_t)(1000 + i), 999, NULL);
+        TEST_ASSERT_NOT_NULL(value);
+        *value = i;
+    }
+    // the time moves on and refreshes the odd keys
+    struct expired_ctx ctx = {0, 0};
+    int64_t now = 1000;
+    for (uint64_t i = 1; i < num_keys; i += 2) {
+        uint64_t * value = oha_tpht_look_up(table, &i, now);
+        TEST_ASSERT_NOT_NULL(value);
+        TEST_ASSERT_EQUAL(0, oha_tpht_set_deadline(table, value, now + (int64_t)num_keys));
+        now += 2;
+        TEST_ASSERT_EQUAL(1, oha_tpht_expire(table, now - 1, count_expired, &ctx));
+        TEST_ASSERT_EQUAL_UINT64(i - 1, ctx.max_key);
+    }
+    TEST_ASSERT_EQUAL(num_keys / 2, ctx.calls);
+
+    int64_t deadline;
+    TEST_ASSERT_TRUE(oha_tpht_next_deadline(table, &deadline));
+    TEST_ASSERT_EQUAL_INT64(1000 + (int64_t)num_keys, deadline);
+    uint64_t key = 0;
+    TEST_ASSERT_NULL(oha_tpht_remove(table, &key));
+    key = 1;
+    TEST_ASSERT_NOT_NULL(oha_tpht_remove(table, &key));
+    TEST_ASSERT_EQUAL(num_keys / 2 - 1, oha_tpht_expire(table, INT64_MAX, count_expired, &ctx));
+
+    struct oha_lpht_status status;
+    TEST_ASSERT_EQUAL(0, oha_tpht_get_status(table, &status));
+    TEST_ASSERT_EQUAL(0, status.elems_in_use);
+    oha_tpht_destroy(table);
+}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tpht_expire);
+    RUN_TEST(test_tpht_expire_batches);
+    RUN_TEST(test_tpht_lazy_look_up);
+    RUN_TEST(test_tpht_set_deadline_remove);
+    RUN_TEST(test_tpht_reset_deadlines);
+    RUN_TEST(test_tpht_monotone_deadlines);
+    return UNITY_END();
+}